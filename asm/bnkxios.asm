@@ -1,6 +1,6 @@
 	;; printed at start increment every change to be sure we
 ;; get the right version
-BNK_VERSION	EQU 25
+BNK_VERSION	EQU 27
 ; bnkxios_port.asm - MP/M II BNKXIOS using I/O port dispatch
 ; Part of MP/M II Emulator
 ; SPDX-License-Identifier: GPL-3.0-or-later
@@ -49,6 +49,10 @@ FUNC_EXITRGN:   EQU     3FH
 FUNC_MAXCON:    EQU     42H
 FUNC_SYSINIT:   EQU     45H
 FUNC_IDLE:      EQU     48H
+FUNC_SETCNT:    EQU     84H     ; Set record count for multi transfer
+FUNC_READM:     EQU     85H     ; Read N records in one dispatch
+FUNC_WRITEM:    EQU     86H     ; Write N records in one dispatch
+FUNC_CONOUTS:   EQU     87H     ; String console output
 
 ; XDOS function codes
 POLL:           EQU     131     ; XDOS poll function
@@ -268,6 +272,44 @@ DO_WRITE:
         IN      A, (XIOS_DISPATCH)      ; Get result in A
         RET
 
+; Multi-record transfer extension (emulator-specific, funcs 84H-86H).
+; After SELDSK/SETTRK/SETSEC/SETDMA, set a record count with MULTIO_SETCNT
+; then one MULTIO_READ/MULTIO_WRITE moves N consecutive 128-byte records,
+; the host advancing sector and DMA per record. BNKBDOS issues one record
+; per READ call so the standard table above is unchanged; these entries
+; are for block-transfer-aware code (loaders, RSPs).
+
+CONOUT_STR:
+        ; String console output - D = console, E = length (0 means 256),
+        ; HL = buffer address. One dispatch moves the whole run into the
+        ; console queue instead of a CONOUT trap per character.
+        ; Returns A = count actually queued; poll and retry the rest if
+        ; the queue was full.
+        LD      A, FUNC_CONOUTS
+        OUT     (XIOS_DISPATCH), A      ; Dispatch function
+        IN      A, (XIOS_DISPATCH)      ; Get count queued in A
+        RET
+
+MULTIO_SETCNT:
+        ; Set record count for next READM/WRITEM - C = count
+        LD      A, FUNC_SETCNT
+        OUT     (XIOS_DISPATCH), A
+        RET
+
+MULTIO_READ:
+        ; Read N consecutive records - returns A = 0 success, A = 1 error
+        LD      A, FUNC_READM
+        OUT     (XIOS_DISPATCH), A      ; Dispatch function
+        IN      A, (XIOS_DISPATCH)      ; Get result in A
+        RET
+
+MULTIO_WRITE:
+        ; Write N consecutive records - returns A = 0 success, A = 1 error
+        LD      A, FUNC_WRITEM
+        OUT     (XIOS_DISPATCH), A      ; Dispatch function
+        IN      A, (XIOS_DISPATCH)      ; Get result in A
+        RET
+
 DO_LISTST:
         ; List status - returns A = 0FFH if ready
         LD      A, FUNC_LISTST
@@ -0,0 +1,117 @@
+// alog.h - Asynchronous logging ring for emulator hot paths
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ALOG_H
+#define ALOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Deferred diagnostics for code on the instruction path (XIOS dispatch,
+// CPU port handlers, disk I/O). Emitting appends a fixed-size record -
+// a printf format pointer plus integer arguments - to a ring; the main
+// loop formats and writes the backlog to stderr when it has slack.
+// A full ring drops new records and counts them rather than blocking.
+//
+// Levels are per-subsystem and runtime-settable (--trace), so debug
+// XIOS tracing can be turned on in production without a rebuild. The
+// level check is one relaxed load; a suppressed record costs nothing
+// else.
+//
+// Format strings must be string literals (the record stores the
+// pointer) and use only integer conversions - arguments are widened to
+// unsigned long. Producers are the Z80-running threads - the main
+// thread, plus one thread per fleet instance - while draining stays on
+// the main thread only. Producers therefore claim a slot by CAS on the
+// head and publish it with a per-record flag; the drain stops at the
+// first claimed-but-unpublished record.
+
+enum class LogSubsys : uint8_t {
+    CPU = 0,   // opcode/dispatch errors in MpmCpu
+    XIOS,      // XIOS call tracing, console errors
+    DISK,      // sector I/O errors and traces
+    BOOT,      // boot-phase diagnostics
+    COUNT
+};
+
+enum class LogLevel : uint8_t {
+    NONE = 0,
+    ERROR,
+    INFO,
+    DEBUG
+};
+
+class AsyncLog {
+public:
+    static AsyncLog& instance();
+
+    static constexpr size_t RING_SIZE = 4096;  // records, power of two
+    static constexpr int MAX_ARGS = 6;
+
+    // True when a record of `level` on `subsys` would be kept
+    bool enabled(LogSubsys subsys, LogLevel level) const {
+        return static_cast<uint8_t>(level) <=
+               level_[static_cast<size_t>(subsys)].load(
+                   std::memory_order_relaxed);
+    }
+
+    void set_level(LogSubsys subsys, LogLevel level);
+
+    // Parse "xios=debug,disk=info" style specs; returns false on an
+    // unknown subsystem or level name
+    bool set_levels(const std::string& spec);
+
+    // Append one record; `fmt` must be a string literal
+    void write(LogSubsys subsys, LogLevel level, const char* fmt,
+               unsigned long a0 = 0, unsigned long a1 = 0,
+               unsigned long a2 = 0, unsigned long a3 = 0,
+               unsigned long a4 = 0, unsigned long a5 = 0);
+
+    // Format and write up to `max_records` queued records to stderr.
+    // Called from the main loop between CPU batches; returns the number
+    // written
+    size_t flush(size_t max_records);
+
+    // Drain everything (shutdown) and report drops if any occurred
+    void flush_all();
+
+    uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    AsyncLog();
+
+    struct Record {
+        const char* fmt;
+        unsigned long args[MAX_ARGS];
+        std::atomic<bool> ready{false};  // set when the record is complete
+    };
+
+    Record ring_[RING_SIZE];
+    std::atomic<size_t> head_{0};  // next write slot
+    std::atomic<size_t> tail_{0};  // next read slot
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint8_t> level_[static_cast<size_t>(LogSubsys::COUNT)];
+};
+
+// Emit a record if the subsystem's level admits it. The level check
+// stays at the call site so argument evaluation is skipped when the
+// record would be dropped.
+#define ALOG(subsys, level, ...)                                          \
+    do {                                                                  \
+        if (AsyncLog::instance().enabled(LogSubsys::subsys,               \
+                                         LogLevel::level)) {              \
+            AsyncLog::instance().write(LogSubsys::subsys,                 \
+                                       LogLevel::level, __VA_ARGS__);     \
+        }                                                                 \
+    } while (0)
+
+// Guard for diagnostics too elaborate for a fixed record (multi-line
+// dumps); the guarded code may write to stderr directly
+#define ALOG_ENABLED(subsys, level) \
+    AsyncLog::instance().enabled(LogSubsys::subsys, LogLevel::level)
+
+#endif // ALOG_H
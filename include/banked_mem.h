@@ -6,8 +6,8 @@
 #define BANKED_MEM_H
 
 #include "qkz80_mem.h"
+#include "block_cache.h"
 #include <cstdint>
-#include <vector>
 #include <memory>
 
 // MP/M II memory model:
@@ -22,17 +22,55 @@
 // because page 0 contains per-process data (FCB at 0x5C, DMA at 0x80, etc.).
 // Only the interrupt vectors (RST 0-7 at 0x00, 0x08, ..., 0x38) need to be
 // the same in each bank. SYSINIT copies these from bank 0 to all other banks.
-
-class BankedMemory : public qkz80_cpu_mem {
+//
+// Storage is one contiguous anonymous mmap: all banks back-to-back,
+// followed by the high common area. The mapping reserves address space
+// only - the kernel backs each page on first write and zero-fills reads
+// before that, so an instance's resident memory is what the guest
+// actually touches, not num_banks * 48KB. The hot path (fetch_mem/
+// store_mem, called once per emulated byte) indexes through two cached
+// raw base pointers - the current bank and common - so there is no
+// per-access bank table lookup or pointer chase. select_bank() just
+// swaps the bank base pointer. The class is final so the compiler can
+// devirtualize accesses made through a BankedMemory*.
+
+class BankedMemory final : public qkz80_cpu_mem {
 public:
     // Create memory with specified number of banks
     // Each bank is BANK_SIZE (48KB), plus COMMON_SIZE (16KB) common area
-    // Total RAM = (num_banks * BANK_SIZE) + COMMON_SIZE
+    // Total address space = (num_banks * BANK_SIZE) + COMMON_SIZE
     explicit BankedMemory(int num_banks = 4);
-
-    // qkz80_cpu_mem interface
-    qkz80_uint8 fetch_mem(qkz80_uint16 addr, bool is_instruction = false) override;
-    void store_mem(qkz80_uint16 addr, qkz80_uint8 byte) override;
+    ~BankedMemory() override;
+
+    BankedMemory(const BankedMemory&) = delete;
+    BankedMemory& operator=(const BankedMemory&) = delete;
+
+    // qkz80_cpu_mem interface - hot path, kept inline
+    qkz80_uint8 fetch_mem(qkz80_uint16 addr, bool is_instruction = false) override {
+        (void)is_instruction;
+        if (addr >= COMMON_BASE) {
+            // High common area (0xC000-0xFFFF)
+            return common_base_[addr - COMMON_BASE];
+        }
+        // Banked area (0x0000-0xBFFF) - includes page 0
+        return bank_base_[addr];
+    }
+
+    void store_mem(qkz80_uint16 addr, qkz80_uint8 byte) override {
+        if (addr >= COMMON_BASE) {
+            common_base_[addr - COMMON_BASE] = byte;
+        } else {
+            bank_base_[addr] = byte;
+        }
+        // Write-watch for the block translation cache (null unless enabled)
+        if (block_cache_) {
+            block_cache_->on_store(current_bank_, addr);
+        }
+    }
+
+    // Attach the block translation cache for store invalidation
+    // (nullptr detaches; the hot path then pays only a null check)
+    void set_block_cache(BlockCache* bc) { block_cache_ = bc; }
 
     // Bank selection (called from XIOS SELMEMORY)
     void select_bank(uint8_t bank);
@@ -46,12 +84,25 @@ public:
     uint8_t read_common(uint16_t addr) const;
     void write_common(uint16_t addr, uint8_t byte);
 
+    // Bulk copy between host buffers and guest memory. memcpy-based,
+    // splitting at the bank/common boundary (0xC000); ranges are clamped
+    // at the top of memory rather than wrapping. Used by all DMA paths
+    // (disk records, SFTP buffers, boot load).
+    void copy_in(uint8_t bank, uint16_t addr, const uint8_t* src, size_t len);
+    void copy_out(uint8_t bank, uint16_t addr, uint8_t* dst, size_t len) const;
+
     // Load data into specific bank at address
     void load(uint8_t bank, uint16_t addr, const uint8_t* data, size_t len);
 
     // Load data into common area
     void load_common(uint16_t addr, const uint8_t* data, size_t len);
 
+    // Raw base pointers into the contiguous allocation (for bulk DMA copies)
+    uint8_t* bank_data(uint8_t bank) { return ram_ + bank * (size_t)BANK_SIZE; }
+    const uint8_t* bank_data(uint8_t bank) const { return ram_ + bank * (size_t)BANK_SIZE; }
+    uint8_t* common_data() { return common_base_; }
+    const uint8_t* common_data() const { return common_base_; }
+
     // Get total number of banks
     int num_banks() const { return num_banks_; }
 
@@ -65,12 +116,18 @@ private:
     int num_banks_;
     uint8_t current_bank_;
 
-    // Memory storage: banks[i] is 48KB for bank i (0x0000-0xBFFF)
-    // Page 0 is part of each bank (not shared)
-    std::vector<std::unique_ptr<uint8_t[]>> banks_;
+    // Contiguous storage: num_banks * BANK_SIZE bytes of banked memory,
+    // then COMMON_SIZE bytes of high common area. Anonymous mmap,
+    // demand-paged by the kernel
+    uint8_t* ram_;
+    size_t ram_size_;
+
+    // Cached base pointers for the hot path
+    uint8_t* bank_base_;     // = ram_ + current_bank_ * BANK_SIZE
+    uint8_t* common_base_;   // = ram_ + num_banks_ * BANK_SIZE
 
-    // High common area: 16KB (0xC000-0xFFFF)
-    std::unique_ptr<uint8_t[]> common_;
+    // Block translation cache write-watch (optional)
+    BlockCache* block_cache_ = nullptr;
 };
 
 #endif // BANKED_MEM_H
@@ -0,0 +1,90 @@
+// block_cache.h - Hot basic-block detection and translation cache
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Detects hot Z80 basic blocks by execution count and maintains the
+// cache and invalidation machinery for the dynamic translation layer.
+// Blocks are keyed by (bank, PC); guest stores into pages holding cached
+// blocks invalidate them via the write-watch hook in BankedMemory.
+//
+// Translating a block to host code (or a pre-decoded micro-op trace)
+// needs the qkz80 core to expose its decoder, which it does not yet.
+// Until that lands upstream, Block::translated stays false and lookup
+// falls through to the interpreter; the detection, cache keying, and
+// invalidation paths here are the parts that live in this tree.
+
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+class BlockCache {
+public:
+    // Executions of a loop head before it is promoted to the cache
+    static constexpr uint32_t HOT_THRESHOLD = 1024;
+
+    // Write-watch granularity: 256-byte pages. MAX_BANKS must cover the
+    // --banks command line limit (32) - on_store() indexes watch_pages_
+    // with the current bank on every guest store
+    static constexpr int PAGE_SHIFT = 8;
+    static constexpr int MAX_BANKS = 32;
+    static constexpr int PAGES_PER_BANK = 0x10000 >> PAGE_SHIFT;
+
+    struct Block {
+        uint8_t bank;
+        uint16_t pc;
+        uint64_t exec_count;
+        bool translated;    // set once a translation exists (see header note)
+    };
+
+    void set_enabled(bool e) { enabled_ = e; }
+    bool enabled() const { return enabled_; }
+
+    // Record a candidate block entry (PC of a backward control transfer).
+    // Promotes the block to the cache once it crosses HOT_THRESHOLD.
+    void record_entry(uint8_t bank, uint16_t pc);
+
+    // Look up a cached block at (bank, pc); nullptr if absent
+    const Block* lookup(uint8_t bank, uint16_t pc) const;
+
+    // Write-watch hook, called from BankedMemory::store_mem when attached.
+    // Cheap page-bitmap test on the fast path; invalidation is the slow path.
+    void on_store(uint8_t bank, uint16_t addr) {
+        if (bank < MAX_BANKS && watch_pages_[bank][addr >> PAGE_SHIFT]) {
+            invalidate(bank, addr);
+        }
+    }
+
+    // Drop all cached blocks in the page containing addr
+    void invalidate(uint8_t bank, uint16_t addr);
+
+    // Statistics
+    size_t hot_blocks() const { return blocks_.size(); }
+    uint64_t invalidations() const { return invalidations_; }
+
+private:
+    static uint32_t key(uint8_t bank, uint16_t pc) {
+        return (static_cast<uint32_t>(bank) << 16) | pc;
+    }
+
+    // Cold-side execution counters: direct-mapped so the profile stays
+    // bounded regardless of how much code the guest touches. A collision
+    // evicts the old counter; only genuinely hot heads survive to promotion.
+    static constexpr size_t COUNTER_SLOTS = 4096;
+    struct CounterSlot {
+        uint32_t key = 0;
+        uint32_t count = 0;
+    };
+    CounterSlot counters_[COUNTER_SLOTS];
+
+    // Hot blocks only
+    std::unordered_map<uint32_t, Block> blocks_;
+
+    bool watch_pages_[MAX_BANKS][PAGES_PER_BANK] = {};
+    bool enabled_ = false;
+    uint64_t invalidations_ = 0;
+};
+
+#endif // BLOCK_CACHE_H
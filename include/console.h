@@ -47,6 +47,15 @@ public:
     // Write character
     void write_char(uint8_t ch);
 
+    // Write a run of characters in one queue operation (XIOS CONOUTS).
+    // Returns count actually queued (less than len if the queue filled).
+    size_t write_string(const uint8_t* data, size_t len);
+
+    // Queue one input character from a session (producer side); records
+    // the enqueue when a trace is being captured. Returns false when
+    // the input queue is full
+    bool post_input(uint8_t ch);
+
     // Reset on disconnect
     void reset();
 
@@ -60,10 +69,20 @@ private:
 };
 
 // Global console manager
+//
+// instance() resolves through a thread-local pointer so fleet mode can
+// give each emulator instance its own manager: the instance thread (and
+// any SSH session thread routed to it) calls bind_to_thread() once, and
+// every later instance() call on that thread sees that machine's
+// consoles. Unbound threads get the process-wide default, which is
+// fleet instance 0 - the single-instance path is unchanged.
 class ConsoleManager {
 public:
     static ConsoleManager& instance();
 
+    // Bind this manager to the calling thread (see above)
+    void bind_to_thread() { tl_current_ = this; }
+
     // Initialize all consoles
     void init();
 
@@ -88,6 +107,10 @@ public:
 
 private:
     ConsoleManager() = default;
+    friend class EmulatorInstance;  // constructs per-instance managers
+
+    static thread_local ConsoleManager* tl_current_;
+
     std::array<std::unique_ptr<Console>, MAX_CONSOLES> consoles_;
     bool initialized_ = false;
     int active_consoles_ = 4;  // Default to 4 consoles (typical MP/M II config)
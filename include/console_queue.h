@@ -5,14 +5,34 @@
 #ifndef CONSOLE_QUEUE_H
 #define CONSOLE_QUEUE_H
 
-#include <queue>
-#include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
 
-// Thread-safe character queue for console I/O
+// Lock-free single-producer/single-consumer character ring for console I/O.
+//
+// Each queue has exactly one producer and one consumer (SSH thread on one
+// side, the Z80 main thread on the other), so the fast paths - try_read,
+// try_write, read_some, write_some and the status queries - are plain
+// acquire/release atomics with no lock. The XIOS CONST/CONIN/CONOUT hot
+// path therefore never touches a mutex.
+//
+// The blocking read()/write() entry points used by SSH threads sleep on a
+// condition variable, but the waiting side registers itself first and the
+// other side only takes the lock to notify when a waiter is present, so
+// the lock-free paths stay lock-free while nobody is blocked.
+//
+// Indices are free-running counters; the buffer index is the counter
+// masked by CAPACITY-1, which requires CAPACITY to be a power of two.
 template<size_t CAPACITY = 256>
 class ConsoleQueue {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0,
+                  "CAPACITY must be a power of two");
+
 public:
     ConsoleQueue() = default;
 
@@ -22,124 +42,263 @@ public:
 
     // Number of characters available for reading
     size_t available() const {
-        std::lock_guard<std::mutex> lock(mtx_);
-        return queue_.size();
+        return tail_.load(std::memory_order_acquire) -
+               head_.load(std::memory_order_acquire);
     }
 
     // Space available for writing
     size_t space() const {
-        std::lock_guard<std::mutex> lock(mtx_);
-        return CAPACITY - queue_.size();
+        return CAPACITY - available();
     }
 
     bool empty() const {
-        std::lock_guard<std::mutex> lock(mtx_);
-        return queue_.empty();
+        return available() == 0;
     }
 
     bool full() const {
-        std::lock_guard<std::mutex> lock(mtx_);
-        return queue_.size() >= CAPACITY;
+        return available() >= CAPACITY;
     }
 
-    // Non-blocking read: returns -1 if empty
+    // Single relaxed load for status polling (XIOS CONST/POLLDEVICE hit
+    // this continuously from the TMP). Set by the producer on enqueue,
+    // cleared by the consumer on drain; a momentarily stale value only
+    // costs one extra poll round.
+    bool ready() const {
+        return ready_.load(std::memory_order_relaxed);
+    }
+
+    // Non-blocking read: returns -1 if empty (consumer side only)
     int try_read() {
-        std::lock_guard<std::mutex> lock(mtx_);
-        if (queue_.empty()) return -1;
-        uint8_t ch = queue_.front();
-        queue_.pop();
-        not_full_.notify_one();
+        bool freed = drain_stale();
+        int ch = pop();
+        if (freed || ch >= 0) wake_writer();
         return ch;
     }
 
     // Blocking read with timeout (milliseconds)
     // Returns -1 on timeout, character value otherwise
     int read(unsigned timeout_ms = 0) {
-        std::unique_lock<std::mutex> lock(mtx_);
-
-        if (timeout_ms == 0) {
-            // Wait indefinitely
-            not_empty_.wait(lock, [this] { return !queue_.empty(); });
-        } else {
-            // Wait with timeout
-            auto deadline = std::chrono::steady_clock::now() +
-                           std::chrono::milliseconds(timeout_ms);
-            if (!not_empty_.wait_until(lock, deadline, [this] { return !queue_.empty(); })) {
-                return -1;  // Timeout
+        int ch = try_read();
+        if (ch >= 0) return ch;
+
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+
+        // Only the raw ring primitives inside the lock: wake_writer()
+        // takes wait_mtx_, so calling it here would self-deadlock
+        bool freed = false;
+        {
+            std::unique_lock<std::mutex> lock(wait_mtx_);
+            read_waiters_.fetch_add(1, std::memory_order_release);
+            for (;;) {
+                freed = drain_stale() || freed;
+                ch = pop();
+                if (ch >= 0) break;
+                if (timeout_ms == 0) {
+                    not_empty_.wait(lock);
+                } else if (not_empty_.wait_until(lock, deadline) ==
+                           std::cv_status::timeout) {
+                    // Last chance before reporting timeout
+                    freed = drain_stale() || freed;
+                    ch = pop();
+                    break;
+                }
             }
+            read_waiters_.fetch_sub(1, std::memory_order_release);
         }
-
-        uint8_t ch = queue_.front();
-        queue_.pop();
-        not_full_.notify_one();
+        if (freed || ch >= 0) wake_writer();
         return ch;
     }
 
-    // Non-blocking write: returns false if full
+    // Non-blocking write: returns false if full (producer side only)
     bool try_write(uint8_t ch) {
-        std::lock_guard<std::mutex> lock(mtx_);
-        if (queue_.size() >= CAPACITY) return false;
-        queue_.push(ch);
-        not_empty_.notify_one();
+        if (!push(ch)) return false;
+        wake_reader();
         return true;
     }
 
     // Blocking write with timeout (milliseconds)
     // Returns false on timeout
     bool write(uint8_t ch, unsigned timeout_ms = 0) {
-        std::unique_lock<std::mutex> lock(mtx_);
-
-        if (timeout_ms == 0) {
-            // Wait indefinitely
-            not_full_.wait(lock, [this] { return queue_.size() < CAPACITY; });
-        } else {
-            // Wait with timeout
-            auto deadline = std::chrono::steady_clock::now() +
-                           std::chrono::milliseconds(timeout_ms);
-            if (!not_full_.wait_until(lock, deadline,
-                    [this] { return queue_.size() < CAPACITY; })) {
-                return false;  // Timeout
+        if (try_write(ch)) return true;
+
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+
+        // As in read(): no wake helpers while holding wait_mtx_
+        bool ok;
+        {
+            std::unique_lock<std::mutex> lock(wait_mtx_);
+            write_waiters_.fetch_add(1, std::memory_order_release);
+            for (;;) {
+                ok = push(ch);
+                if (ok) break;
+                if (timeout_ms == 0) {
+                    not_full_.wait(lock);
+                } else if (not_full_.wait_until(lock, deadline) ==
+                           std::cv_status::timeout) {
+                    ok = push(ch);
+                    break;
+                }
             }
+            write_waiters_.fetch_sub(1, std::memory_order_release);
         }
-
-        queue_.push(ch);
-        not_empty_.notify_one();
-        return true;
+        if (ok) wake_reader();
+        return ok;
     }
 
-    // Write multiple characters, returns count written
+    // Write multiple characters, returns count written (producer side)
     size_t write_some(const uint8_t* data, size_t len) {
-        std::lock_guard<std::mutex> lock(mtx_);
-        size_t count = 0;
-        while (count < len && queue_.size() < CAPACITY) {
-            queue_.push(data[count++]);
-        }
-        if (count > 0) not_empty_.notify_one();
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free_space = CAPACITY - (tail - head_.load(std::memory_order_acquire));
+        size_t count = len < free_space ? len : free_space;
+        if (count == 0) return 0;
+
+        // At most two contiguous spans (wrap at end of buffer)
+        size_t idx = tail & MASK;
+        size_t first = count < CAPACITY - idx ? count : CAPACITY - idx;
+        std::memcpy(&buf_[idx], data, first);
+        std::memcpy(&buf_[0], data + first, count - first);
+
+        tail_.store(tail + count, std::memory_order_release);
+        ready_.store(true, std::memory_order_relaxed);
+        wake_reader();
         return count;
     }
 
-    // Read multiple characters, returns count read
+    // Read multiple characters, returns count read (consumer side)
     size_t read_some(uint8_t* data, size_t max_len) {
-        std::lock_guard<std::mutex> lock(mtx_);
-        size_t count = 0;
-        while (count < max_len && !queue_.empty()) {
-            data[count++] = queue_.front();
-            queue_.pop();
+        bool freed = drain_stale();
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t avail = tail_.load(std::memory_order_acquire) - head;
+        size_t count = max_len < avail ? max_len : avail;
+        if (count == 0) {
+            if (freed) wake_writer();
+            return 0;
         }
-        if (count > 0) not_full_.notify_one();
+
+        size_t idx = head & MASK;
+        size_t first = count < CAPACITY - idx ? count : CAPACITY - idx;
+        std::memcpy(data, &buf_[idx], first);
+        std::memcpy(data + first, &buf_[0], count - first);
+
+        head_.store(head + count, std::memory_order_release);
+        update_ready(head + count);
+        wake_writer();
         return count;
     }
 
-    // Clear all queued data
+    // Discard all queued data (consumer side)
     void clear() {
-        std::lock_guard<std::mutex> lock(mtx_);
-        while (!queue_.empty()) queue_.pop();
-        not_full_.notify_all();
+        size_t tail = tail_.load(std::memory_order_acquire);
+        head_.store(tail, std::memory_order_release);
+        update_ready(tail);
+        wake_writer();
+    }
+
+    // Producer-safe drain: mark everything queued so far as stale; the
+    // consumer discards up to the mark on its next read. Only the
+    // producer-owned tail is touched here - head advances on the
+    // consumer side in drain_stale(), so unlike clear() this is safe to
+    // call from the producer thread (e.g. flushing stale input when an
+    // SSH session reconnects). Bytes written after the call survive.
+    void drain() {
+        drain_to_.store(tail_.load(std::memory_order_relaxed),
+                        std::memory_order_release);
     }
 
 private:
-    std::queue<uint8_t> queue_;
-    mutable std::mutex mtx_;
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    // Raw ring primitives shared by the lock-free entry points and the
+    // blocking loops. They mutate the ring but never notify: the wake
+    // helpers take wait_mtx_, which the blocking read()/write() loops
+    // already hold, so each public entry point issues its own wake
+    // after any lock is released.
+
+    // Consumer: pop one character, -1 if empty
+    int pop() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head) return -1;
+        uint8_t ch = buf_[head & MASK];
+        head_.store(head + 1, std::memory_order_release);
+        update_ready(head + 1);
+        return ch;
+    }
+
+    // Producer: push one character, false if full
+    bool push(uint8_t ch) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= CAPACITY) {
+            return false;
+        }
+        buf_[tail & MASK] = ch;
+        tail_.store(tail + 1, std::memory_order_release);
+        ready_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer: skip past anything the producer marked stale via
+    // drain(); true when head moved (the caller owes a wake_writer).
+    // The counters are free-running, so the signed difference tells
+    // whether the mark is still ahead of head; a mark from long ago
+    // compares non-positive and is ignored.
+    bool drain_stale() {
+        size_t d = drain_to_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (static_cast<std::ptrdiff_t>(d - head) <= 0) return false;
+        head_.store(d, std::memory_order_release);
+        update_ready(d);
+        return true;
+    }
+
+    // Wake a blocked reader/writer. Taking the lock before notifying
+    // closes the race with a waiter that passed its try_ check but has
+    // not started waiting yet; the lock is only touched when the waiter
+    // counter says someone is actually blocked.
+    void wake_reader() {
+        if (read_waiters_.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(wait_mtx_);
+            not_empty_.notify_one();
+        }
+    }
+
+    // Consumer side: recompute the ready flag after advancing head.
+    // If the producer enqueued between the emptiness check and the
+    // clear, the re-check restores the flag.
+    void update_ready(size_t head) {
+        if (tail_.load(std::memory_order_acquire) == head) {
+            ready_.store(false, std::memory_order_relaxed);
+            if (tail_.load(std::memory_order_acquire) != head) {
+                ready_.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void wake_writer() {
+        if (write_waiters_.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(wait_mtx_);
+            not_full_.notify_one();
+        }
+    }
+
+    uint8_t buf_[CAPACITY];
+
+    // Consumer and producer indices on separate cache lines so the two
+    // sides don't false-share
+    alignas(64) std::atomic<size_t> head_{0};  // Consumer: next read position
+    alignas(64) std::atomic<size_t> tail_{0};  // Producer: next write position
+
+    // Status-poll mirror of "queue non-empty" (see ready())
+    std::atomic<bool> ready_{false};
+
+    // Producer-set drain mark (see drain())
+    std::atomic<size_t> drain_to_{0};
+
+    // Blocking support (read()/write() only)
+    std::atomic<int> read_waiters_{0};
+    std::atomic<int> write_waiters_{0};
+    mutable std::mutex wait_mtx_;
     std::condition_variable not_empty_;
     std::condition_variable not_full_;
 };
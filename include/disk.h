@@ -10,6 +10,7 @@
 #include <fstream>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 // Disk Parameter Header (DPH) - 16 bytes
 struct DiskParameterHeader {
@@ -45,18 +46,46 @@ enum class DiskFormat {
     CUSTOM      // Custom geometry
 };
 
+// Write sync policy (--sync command line option)
+enum class SyncPolicy {
+    ALWAYS,     // Write-through: sync every sector write
+    PERIODIC,   // Write-back: main loop flushes dirty data periodically
+    CLOSE       // Write-back: flush only on unmount/shutdown
+};
+
 // Single disk drive
+//
+// Images are memory-mapped when possible so sector reads are a pointer
+// into the page cache instead of seekg/read syscalls; buffered fstream
+// I/O remains as the fallback (e.g. filesystems that refuse mmap).
+//
+// Copy-on-write overlays: a path of the form "base.img+overlay.ovl"
+// opens the base image read-only and directs all writes to a sparse
+// per-instance overlay file. A presence bitmap records which 512-byte
+// blocks have been written; reads come from the overlay when the block
+// is present and from the base otherwise. Many instances can share one
+// page-cache-resident base image without copying it per instance.
+//
+// Sparse container images: cluster-allocated image files (mksparse
+// tool) are auto-detected by magic in open(). Only clusters holding
+// data are stored; unallocated clusters read as directory-empty 0xE5
+// filler, so a mostly-empty hd1k image shrinks from 8MB to the size of
+// its actual contents. Reads and writes go through pread/pwrite with
+// clusters allocated at end of file on first write.
 class Disk {
 public:
     Disk();
     ~Disk();
 
-    // Open disk image file
+    // Open disk image file (mmap-backed when possible)
+    // "base+overlay" opens base read-only with a copy-on-write overlay
+    // (created on first use); overlay mounts require a mappable base
     bool open(const std::string& path, bool read_only = false);
     void close();
 
-    bool is_open() const { return file_.is_open(); }
+    bool is_open() const { return map_ != nullptr || sparse_ || file_.is_open(); }
     bool is_read_only() const { return read_only_; }
+    bool is_mapped() const { return map_ != nullptr; }
 
     // Disk geometry
     void set_geometry(uint16_t sectors_per_track, uint16_t tracks,
@@ -81,6 +110,21 @@ public:
     int read_sector(uint8_t* buffer);
     int write_sector(const uint8_t* buffer);
 
+    // Zero-copy access to a physical sector in the mapped image.
+    // Returns nullptr when not mmap-backed or out of range; callers fall
+    // back to read_sector(). The mutable variant additionally returns
+    // nullptr for read-only images.
+    const uint8_t* sector_ptr(uint16_t track, uint16_t sector) const;
+    uint8_t* sector_ptr_mut(uint16_t track, uint16_t sector);
+
+    // Flush pending writes to stable storage (msync for mapped images,
+    // dirty-set writeback + stream flush otherwise). Barrier used by the
+    // periodic main-loop flush and by close().
+    void flush();
+
+    void set_sync_policy(SyncPolicy policy) { sync_policy_ = policy; }
+    SyncPolicy sync_policy() const { return sync_policy_; }
+
     // Get DPB for standard disk formats
     const DiskParameterBlock& dpb() const { return dpb_; }
 
@@ -88,9 +132,56 @@ private:
     // Calculate file offset for current track/sector
     size_t sector_offset() const;
 
+    // Write buffered dirty sectors through to the file (fstream fallback)
+    void write_back_dirty();
+
     std::fstream file_;
     std::string path_;
     bool read_only_;
+    SyncPolicy sync_policy_ = SyncPolicy::PERIODIC;
+
+    // Write-back cache for the fstream fallback: coalesces repeated
+    // writes to the same sector and avoids a flush per BDOS record.
+    // Bounded; spills to the file when full. Keyed by byte offset.
+    static constexpr size_t DIRTY_LIMIT = 256;
+    std::unordered_map<size_t, std::vector<uint8_t>> dirty_sectors_;
+
+    // mmap backing (preferred); file_ is the fallback
+    uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    int fd_ = -1;
+
+    // Copy-on-write overlay. The overlay file holds a small header, a
+    // presence bitmap and a dense data region (block i at fixed offset
+    // i * OVL_BLOCK); unwritten blocks stay filesystem holes, so the
+    // file is sparse on disk. Every CP/M sector (128 or 512 bytes,
+    // aligned) fits inside one overlay block.
+    static constexpr uint32_t OVL_BLOCK = 512;
+    bool open_overlay(const std::string& path);
+    bool ovl_present(size_t block) const {
+        return (ovl_bitmap_[block >> 3] >> (block & 7)) & 1;
+    }
+    // Populate the block from the base if absent, mark it present and
+    // return its data pointer (nullptr when out of range)
+    uint8_t* ovl_block_for_write(size_t offset);
+
+    uint8_t* ovl_map_ = nullptr;
+    size_t ovl_map_size_ = 0;
+    int ovl_fd_ = -1;
+    uint8_t* ovl_bitmap_ = nullptr;  // into ovl_map_
+    uint8_t* ovl_data_ = nullptr;    // into ovl_map_
+    size_t ovl_blocks_ = 0;
+
+    // Sparse container state. The in-memory cluster table mirrors the
+    // on-disk one; entry 0 = unallocated, N = Nth data cluster. Every
+    // CP/M sector fits inside one cluster (sizes are powers of two).
+    bool sp_open(const std::string& path);
+    bool sparse_ = false;
+    uint32_t sp_cluster_size_ = 0;
+    uint64_t sp_virtual_size_ = 0;
+    size_t sp_data_start_ = 0;
+    uint32_t sp_allocated_ = 0;     // data clusters in the file so far
+    std::vector<uint32_t> sp_table_;
 
     DiskFormat format_;
     uint16_t sectors_per_track_;
@@ -104,16 +195,30 @@ private:
 };
 
 // Disk subsystem - manages multiple drives
+//
+// instance() resolves through a thread-local pointer (same scheme as
+// ConsoleManager) so each fleet instance runs against its own set of
+// mounted drives; unbound threads get the process-wide default
 class DiskSystem {
 public:
     static constexpr int MAX_DISKS = 16;
 
     static DiskSystem& instance();
 
+    // Bind this disk system to the calling thread (fleet mode)
+    void bind_to_thread() { tl_current_ = this; }
+
     // Mount disk image on drive (0 = A:, 1 = B:, etc.)
     bool mount(int drive, const std::string& path, bool read_only = false);
     void unmount(int drive);
 
+    // Sync policy applied to all mounted drives (and future mounts)
+    void set_sync_policy(SyncPolicy policy);
+
+    // Flush dirty data on all mounted drives (periodic main-loop call
+    // and shutdown barrier)
+    void flush_all();
+
     // Get disk by drive number
     Disk* get(int drive);
 
@@ -133,13 +238,30 @@ public:
     int read(class BankedMemory* mem);
     int write(class BankedMemory* mem);
 
+    // Multi-sector transfer (XIOS READM/WRITEM): move count consecutive
+    // 128-byte records starting at the current track/sector, advancing
+    // the DMA address by 128 per record and wrapping to the next track
+    // at end of track
+    int read_multi(class BankedMemory* mem, int count);
+    int write_multi(class BankedMemory* mem, int count);
+
     // Sector translation (for skewed disks)
     uint16_t translate(uint16_t logical_sector, uint16_t track);
 
 private:
     DiskSystem();
+    friend class EmulatorInstance;  // constructs per-instance disk systems
+
+    static thread_local DiskSystem* tl_current_;
+
+    // Move one 128-byte record at the given logical position
+    int read_record(Disk* disk, class BankedMemory* mem,
+                    uint16_t track, uint16_t logical_sector, uint16_t dma);
+    int write_record(Disk* disk, class BankedMemory* mem,
+                     uint16_t track, uint16_t logical_sector, uint16_t dma);
 
     std::unique_ptr<Disk> disks_[MAX_DISKS];
+    SyncPolicy sync_policy_ = SyncPolicy::PERIODIC;
     int current_drive_;
     uint16_t dma_addr_;
     uint8_t dma_bank_;          // Target bank for DMA to banked addresses
@@ -38,6 +38,10 @@ public:
     // Check if server is running (has at least one listener)
     bool is_running() const { return !listeners_.empty(); }
 
+    // Number of open client connections (used to skip idle sleep while
+    // a request is in flight)
+    size_t connection_count() const { return connections_.size(); }
+
     // Get listen addresses
     const std::vector<ListenAddress>& listen_addresses() const { return listen_addrs_; }
 
@@ -61,6 +65,7 @@ public:
         LISTING_ROOT,       // Building root drive listing
         LISTING_DIR,        // Fetching directory from Z80
         READING_FILE,       // Reading file from Z80
+        STREAMING_FILE,     // Streaming file chunks straight to socket
         SENDING_RESPONSE,   // Sending HTTP response
         DONE                // Connection complete
     };
@@ -100,6 +105,7 @@ private:
     };
 
     // Z80 request state
+    uint32_t origin_ = 0;       // bridge origin id for fair scheduling
     uint32_t pending_request_id_ = 0;
     bool search_first_ = true;  // First directory search?
     bool file_opened_ = false;  // File open request completed?
@@ -108,6 +114,17 @@ private:
     std::vector<uint8_t> file_data_;
     std::vector<DirEntry> dir_entries_;
 
+    // Streaming download state (GET of a file). Bridge reply payloads
+    // go to the socket with chunked transfer encoding via writev -
+    // framing, payload and trailer in one call, no whole-file buffer.
+    std::string stream_hdr_;            // chunk-size line ("<hex>\r\n")
+    std::vector<uint8_t> stream_data_;  // current chunk payload
+    size_t stream_sent_ = 0;            // bytes of current chunk sent
+    bool stream_done_ = false;          // final bridge chunk received
+    bool stream_finish_ = false;        // terminator queued, close after
+    bool text_mode_ = false;            // strip CR, stop at ctrl-Z
+    bool text_eof_ = false;             // ctrl-Z seen - discard the rest
+
     // Request handling
     bool read_request();
     bool parse_request();
@@ -119,6 +136,9 @@ private:
     void build_dir_response();
     void start_file_read();
     bool poll_file_read();
+    bool poll_file_stream();
+    void queue_stream_chunk(std::vector<uint8_t> data);
+    void finish_stream();
     void build_file_response();
     void build_error_response(int code, const std::string& message);
     bool send_response();
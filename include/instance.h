@@ -0,0 +1,90 @@
+// instance.h - One emulator instance for fleet mode
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Fleet mode runs several independent MP/M II machines in one process,
+// scheduled across host cores. Each EmulatorInstance owns the per-machine
+// state that is otherwise a process-wide singleton - consoles, disks,
+// SFTP bridge, wakeup pipe - plus its own Z80Runner, and runs them on a
+// dedicated thread. Those singletons resolve instance() through a
+// thread-local pointer, so XIOS and bridge code needs no changes:
+// whichever thread is running (an instance thread, or an SSH session
+// thread routed to the instance) sees its own machine. The process-wide
+// defaults act as instance 0, which stays on the main thread with the
+// existing loop; with --fleet 1 no EmulatorInstance exists at all.
+//
+// This is the one sanctioned extension of the threading policy beyond
+// libssh: an instance thread is that machine's "main thread". Its Z80
+// only ever runs there, and cross-thread communication still goes
+// exclusively through ConsoleQueue and SftpBridge. Stats, AsyncLog and
+// the access logger remain process-global (aggregated across instances).
+
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include "console.h"
+#include "disk.h"
+#include "sftp_bridge.h"
+#include "wakeup.h"
+#include "z80_runner.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class EmulatorInstance {
+public:
+    // Construct instance `id` (1 to N-1; 0 is the main-thread machine)
+    // and register it for lookup. Disks are mounted and the machine
+    // booted on the instance thread, not here
+    EmulatorInstance(int id,
+                     std::vector<std::pair<int, std::string>> mounts,
+                     SyncPolicy sync_policy, int num_banks, bool turbo,
+                     bool fastboot);
+    ~EmulatorInstance();
+
+    EmulatorInstance(const EmulatorInstance&) = delete;
+    EmulatorInstance& operator=(const EmulatorInstance&) = delete;
+
+    int id() const { return id_; }
+
+    // Start the instance thread (mounts, boots, runs the Z80 loop)
+    void start();
+
+    // Request shutdown and join the thread (flushes disks on the way out)
+    void stop();
+
+    // Bind the calling thread to this instance's consoles, disks, bridge
+    // and wakeup. Called by the instance thread at startup and by SSH
+    // session threads routed here (see SSHSession::route_to_instance)
+    void bind_to_thread();
+
+    // Look up an instance by id; nullptr for id 0 (the main-thread
+    // machine has no EmulatorInstance) or out-of-range ids. The registry
+    // is filled on the main thread before the SSH server starts and
+    // read-only afterwards, so lookup needs no locking
+    static EmulatorInstance* get(int id);
+
+private:
+    // Thread entry: bind, mount, boot, then the polling loop
+    void run();
+
+    int id_;
+    std::vector<std::pair<int, std::string>> mounts_;
+    SyncPolicy sync_policy_;
+    bool turbo_;
+    bool fastboot_;
+
+    // Per-machine state (the singletons' per-instance counterparts)
+    ConsoleManager consoles_;
+    DiskSystem disks_;
+    SftpBridge bridge_;
+    Wakeup wakeup_;
+    Z80Runner z80_;
+
+    std::thread thread_;
+    std::atomic<bool> stop_requested_{false};
+};
+
+#endif // INSTANCE_H
@@ -9,6 +9,7 @@
 #include <cstdint>
 
 class BankedMemory;
+class BlockCache;
 class XIOS;
 
 // I/O Port definitions for MP/M II emulator
@@ -31,6 +32,10 @@ public:
     // Set banked memory for bank switching
     void set_banked_mem(BankedMemory* mem) { banked_mem_ = mem; }
 
+    // Set block translation cache (enables hot-block profiling in
+    // execute_batch; nullptr disables)
+    void set_block_cache(BlockCache* bc) { block_cache_ = bc; }
+
     // Override port I/O - routes through emulator handlers
     void port_out(qkz80_uint8 port, qkz80_uint8 value) override;
     qkz80_uint8 port_in(qkz80_uint8 port) override;
@@ -38,6 +43,12 @@ public:
     // Override execute for instruction tracing
     void execute(void) override;
 
+    // Run up to n instructions in a tight loop without per-instruction
+    // interrupt or clock checks (the runner hoists those to batch
+    // boundaries). Stops early when the CPU halts. Returns the number
+    // of instructions actually executed.
+    int execute_batch(int n);
+
     // Override unimplemented opcode - for better diagnostics
     void unimplemented_opcode(qkz80_uint8 opcode, qkz80_uint16 pc) override;
 
@@ -46,8 +57,13 @@ public:
 private:
     XIOS* xios_ = nullptr;
     BankedMemory* banked_mem_ = nullptr;
+    BlockCache* block_cache_ = nullptr;
     uint8_t last_xios_result_ = 0;  // Result from last XIOS dispatch (for IN instruction)
 
+    // Batch execution with hot-block profiling (used when a block cache
+    // is attached)
+    int execute_batch_profiled(int n);
+
     // Handle XIOS dispatch via port 0xE0
     void handle_xios_dispatch();
 
@@ -0,0 +1,48 @@
+// poll_set.h - Shared socket readiness set for HTTP and SSH servers
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// One epoll (Linux) / kqueue (macOS) instance holds every listener and
+// connection socket the main loop cares about. Each main-loop pass makes
+// a single wait(0) syscall and the servers check ready() for their own
+// fds, instead of probing every socket with non-blocking calls. The set
+// is level-triggered, so readiness a server does not consume this pass
+// shows up again on the next wait().
+
+#ifndef POLL_SET_H
+#define POLL_SET_H
+
+#include <cstddef>
+#include <vector>
+
+class PollSet {
+public:
+    static PollSet& instance();
+
+    // Register/unregister a socket for read-readiness tracking
+    bool add(int fd);
+    void remove(int fd);
+
+    // Collect ready fds, waiting up to timeout_ms (0 = return
+    // immediately). Returns the number of ready fds in the snapshot.
+    size_t wait(int timeout_ms);
+
+    // Was fd ready in the last wait() snapshot?
+    bool ready(int fd) const;
+
+    // Underlying epoll/kqueue fd. It is itself pollable and reads ready
+    // whenever any registered socket has events - the idle sleep blocks
+    // on it so new connections wake the main loop immediately.
+    int fd() const { return poll_fd_; }
+
+private:
+    PollSet();
+    ~PollSet();
+    PollSet(const PollSet&) = delete;
+    PollSet& operator=(const PollSet&) = delete;
+
+    int poll_fd_ = -1;
+    std::vector<int> ready_fds_;
+};
+
+#endif // POLL_SET_H
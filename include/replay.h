@@ -0,0 +1,94 @@
+// replay.h - Deterministic record/replay of nondeterministic inputs
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct SftpRequest;
+
+// Records every nondeterministic input to the guest - tick deliveries,
+// console input characters, bridge request arrivals - tagged with the
+// instruction count at which it happened, to a compact binary trace
+// (--record). Replay (--replay) re-injects the same events at the same
+// instruction counts with the runner in turbo mode, so a captured run
+// re-executes at full host speed with identical guest-visible timing;
+// combined with the PC profiler this makes slow runs reproducible on
+// the bench.
+//
+// Producers call the record_* hooks from wherever the event enters the
+// system (the main thread for ticks, SSH session threads for console
+// and bridge input); a mutex serializes the trace writes, like the
+// access logger. Replay injection happens between batches on the main
+// thread, which therefore owns the producer side of the input queues -
+// replay runs are meant to be driven by the trace, not by live
+// sessions. Record/replay covers the main-thread machine only and is
+// rejected in fleet mode.
+class Replay {
+public:
+    static Replay& instance();
+
+    // Instruction-count source for timestamps (the runner's retired
+    // count); set before recording starts
+    void set_clock(std::function<uint64_t()> clock) { clock_ = std::move(clock); }
+
+    // Open `path` and start recording (false on I/O error)
+    bool start_record(const std::string& path);
+
+    // Load `path` for replay (false on I/O error or bad header)
+    bool start_replay(const std::string& path);
+
+    bool recording() const { return mode_ == Mode::RECORD; }
+    // True while trace events remain to be injected
+    bool replaying() const { return mode_ == Mode::REPLAY; }
+
+    // Record hooks (no-ops unless recording)
+    void record_tick();
+    void record_console(uint8_t console, uint8_t ch);
+    void record_bridge(const SftpRequest& req);
+
+    // Instruction count of the next pending trace event (replay only)
+    uint64_t next_event_instr() const { return next_instr_; }
+
+    // Inject every event due at or before `instr`: console characters
+    // and bridge requests go straight into their queues; tick events are
+    // returned as a count for the caller to deliver. A halted CPU
+    // retires no instructions, so with `halted` set the earliest event
+    // is treated as due - otherwise replay would never advance
+    int inject_due(uint64_t instr, bool halted);
+
+    // Flush and close the trace (recording); safe to call regardless
+    void close();
+
+private:
+    Replay() = default;
+
+    enum class Mode { NONE, RECORD, REPLAY };
+
+    // Parse the next event header+payload into next_*; flips mode to
+    // NONE at end of trace
+    void fetch_next();
+
+    Mode mode_ = Mode::NONE;
+    std::function<uint64_t()> clock_;
+    std::mutex mutex_;           // serializes trace writes
+    std::ofstream out_;
+    std::ifstream in_;
+
+    // Pending replay event
+    uint8_t next_type_ = 0;
+    uint64_t next_instr_ = 0;
+    std::vector<uint8_t> next_payload_;
+
+    uint64_t events_recorded_ = 0;
+    uint64_t events_injected_ = 0;
+};
+
+#endif // REPLAY_H
@@ -11,8 +11,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <map>
 #include <optional>
-#include <functional>
 
 // SFTP request types (sent to Z80)
 enum class SftpRequestType : uint8_t {
@@ -43,7 +43,8 @@ enum class SftpReplyStatus : uint8_t {
 //   [0]     type (SftpRequestType)
 //   [1]     drive (0=A, 1=B, ...)
 //   [2]     user (0-15)
-//   [3]     flags (search: 0=first, 1=next; open: bit0=create)
+//   [3]     flags (search: 0=first, 1=next; open: bit0=create;
+//            read: bit1=stream all chunks for one request)
 //   [4-11]  filename (8 bytes, space padded)
 //   [12-14] extension (3 bytes, space padded)
 //   [15-16] offset_low (for read/write)
@@ -58,6 +59,12 @@ constexpr size_t SFTP_LENGTH_OFS = 19;
 constexpr size_t SFTP_DATA_OFS = 21;
 constexpr size_t SFTP_MAX_DATA = SFTP_BUF_SIZE - SFTP_DATA_OFS;
 
+// Request flag bits (byte [3])
+// STREAM: the RSP sends every reply chunk for this request back to back
+// (MORE_DATA set on all but the last) instead of one chunk per request.
+// Avoids a poll/get round trip through the Z80 scheduler per ~2KB.
+constexpr uint8_t SFTP_FLAG_STREAM = 0x02;
+
 // Reply structure from Z80 buffer
 // Buffer layout:
 //   [0]     status (SftpReplyStatus, bit 7 = more data)
@@ -80,6 +87,7 @@ constexpr size_t SFTP_DIRENT_SIZE = 32;
 // High-level request structure (C++ side)
 struct SftpRequest {
     uint32_t id;                // Request ID for matching replies
+    uint32_t origin = 0;        // Session/connection id for fair scheduling
     SftpRequestType type;
     uint8_t drive;              // 0=A, 1=B, etc.
     uint8_t user;               // User area 0-15
@@ -105,17 +113,26 @@ struct SftpReply {
     static SftpReply deserialize(const uint8_t* buf, size_t buf_size);
 };
 
-// Callback type for running Z80 during wait
-using Z80TickCallback = std::function<void()>;
-
 // Bridge class for managing request/reply queue
-// Thread-safe for C++ SSH handlers to enqueue requests
+// Thread-safe for C++ SSH handlers to enqueue requests.
+// SSH threads block on reply_cv_ in wait_for_reply() while the main
+// thread runs the Z80 and wakes them via set_reply(); HTTP (main
+// thread) must use the non-blocking try_get_reply() instead.
+//
+// instance() resolves through a thread-local pointer (same scheme as
+// ConsoleManager) so requests from an SSH session routed to a fleet
+// instance land in that instance's queues; unbound threads get the
+// process-wide default.
 class SftpBridge {
 public:
     static SftpBridge& instance();
 
-    // Set callback for running Z80 during wait_for_reply
-    void set_z80_tick_callback(Z80TickCallback cb) { z80_tick_ = cb; }
+    // Bind this bridge to the calling thread (fleet mode)
+    void bind_to_thread() { tl_current_ = this; }
+
+    // Allocate a unique origin id - one per SSH session / HTTP
+    // connection - used to schedule requests fairly across sessions
+    uint32_t allocate_origin();
 
     // C++ side (called from SSH handler thread)
     uint32_t enqueue_request(SftpRequest req);
@@ -133,16 +150,37 @@ public:
 
 private:
     SftpBridge() = default;
+    friend class EmulatorInstance;  // constructs per-instance bridges
+
+    static thread_local SftpBridge* tl_current_;
+
+    // Dequeue the next request of one priority class, round-robin over
+    // origins starting after `cursor`. Caller holds mutex_.
+    bool take_from_class(bool bulk, uint32_t& cursor,
+                         uint8_t* buf, size_t buf_size);
 
     mutable std::mutex mutex_;
     std::condition_variable reply_cv_;
 
-    std::queue<SftpRequest> pending_requests_;
+    // Per-origin request queues in two priority classes: metadata ops
+    // (search/open/close/...) are served before bulk FILE_READ/WRITE
+    // data so one session's transfer cannot starve directory listings
+    // and stats from other sessions; within a class, origins are
+    // served round-robin.
+    struct OriginQueues {
+        std::queue<SftpRequest> meta;
+        std::queue<SftpRequest> bulk;
+    };
+    std::map<uint32_t, OriginQueues> pending_requests_;
+    size_t pending_count_ = 0;
+    uint32_t meta_cursor_ = 0;      // last origin served per class
+    uint32_t bulk_cursor_ = 0;
+
     std::optional<SftpRequest> current_request_;
     std::queue<SftpReply> pending_replies_;
 
     uint32_t next_request_id_ = 1;
-    Z80TickCallback z80_tick_;
+    uint32_t next_origin_id_ = 1;
 };
 
 #endif // SFTP_BRIDGE_H
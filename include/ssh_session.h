@@ -16,8 +16,10 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <deque>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <libssh/libssh.h>
 #include <libssh/server.h>
 #include <libssh/callbacks.h>
@@ -73,6 +75,12 @@ public:
     // Accessors for authentication callbacks
     SSHServer* server() const;
     void set_authenticated(bool auth);
+
+    // Fleet routing: a username of the form "name+N" directs this
+    // session to fleet instance N (default: instance 0). Called from
+    // the auth callbacks, which run on the session thread, so the
+    // binding covers every later console/bridge call this session makes
+    void route_to_instance(const char* user);
     void set_channel(ssh_channel channel);
     void setup_channel_callbacks(ssh_channel channel);
     void setup_console();
@@ -94,6 +102,10 @@ private:
     bool poll_io();
     bool poll_sftp();
 
+    // Write buffered console output to the channel (window permitting).
+    // Returns false on channel error.
+    bool flush_output();
+
     // Thread management
     std::thread thread_;
     std::atomic<bool> stop_requested_{false};
@@ -116,6 +128,17 @@ private:
     sftp_session sftp_;
     bool is_sftp_;
 
+    // Output aggregation: console bytes are coalesced here and flushed
+    // in one ssh_channel_write() when the buffer fills, a short deadline
+    // expires, or the console queue drains (keeps interactive echo
+    // latency low). Cuts per-byte syscall/encryption overhead for
+    // scrolling output.
+    static constexpr size_t OUTBUF_SIZE = 4096;
+    static constexpr std::chrono::milliseconds FLUSH_DEADLINE{5};
+    uint8_t outbuf_[OUTBUF_SIZE];
+    size_t outbuf_len_ = 0;
+    std::chrono::steady_clock::time_point outbuf_since_{};
+
     // SFTP directory handles
     struct OpenDir {
         int drive;
@@ -146,13 +169,43 @@ private:
         bool is_read_only;
         bool is_write;          // File opened for writing
         bool file_created;      // File was created (new or truncated)
-        // Cached file data - entire file read at open via RSP bridge
-        // For write mode, this accumulates written data until close
+        // File data buffer. Read mode: chunks from the streamed FILE_READ
+        // are pulled in here as the client consumes (read-ahead lives in
+        // the bridge reply queue). Write mode: client writes accumulate
+        // here; full chunks are flushed behind the client's back.
         std::vector<uint8_t> cached_data;
+
+        // Streamed read state (read mode)
+        uint32_t read_req_id = 0;
+        bool read_active = false;   // stream has chunks outstanding
+        bool read_error = false;
+
+        // Write-behind state (write mode)
+        uint64_t flushed = 0;               // bytes already sent to RSP
+        std::deque<uint32_t> write_ids;     // in-flight FILE_WRITE requests
+        bool write_error = false;
     };
     std::map<void*, std::unique_ptr<OpenFile>> open_files_;
 
+    // Bridge transfer sizing: chunks stay a multiple of the 128-byte
+    // CP/M record so only the final flush gets ctrl-Z padding, and a
+    // small window of unacknowledged writes keeps the RSP busy while
+    // the client sends more data.
+    static constexpr size_t FILE_CHUNK = 1920;
+    static constexpr size_t WRITE_WINDOW = 4;
+
+    // Pull streamed read chunks until cached_data covers `need` bytes or
+    // EOF; drains already-arrived chunks first. Returns false on error.
+    bool pull_read_chunks(OpenFile* file, uint64_t need);
+
+    // Flush buffered write data to the RSP in full chunks (everything,
+    // padded, when final) and reap replies down to the window.
+    // Returns false once any chunk has failed.
+    bool flush_write_chunks(OpenFile* file, bool final_flush);
+
     uint32_t next_handle_id_ = 1;
+    uint32_t sftp_origin_ = 0;  // bridge origin id for fair scheduling
+    int fleet_instance_ = 0;    // instance this session is routed to
 };
 
 // SSH server - accepts connections (non-blocking)
@@ -0,0 +1,105 @@
+// stats.h - Runtime instrumentation counters for the /stats endpoint
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Global counters answering "what is this instance doing": per-function
+// XIOS call counts with latency histograms, disk records moved per
+// drive, and bridge requests by type. Exported as JSON via the HTTP
+// server's /stats endpoint.
+//
+// All counters are relaxed atomics - the XIOS dispatch path pays two
+// clock reads and a few uncontended increments per call, which is noise
+// next to the dispatch itself. Writers are the main thread except for
+// the bridge counters (SSH threads enqueue requests).
+class Stats {
+public:
+    static Stats& instance();
+
+    static constexpr int XIOS_FUNCS = 0x90;    // covers 0x00-0x87 entries
+    static constexpr int LAT_BUCKETS = 24;     // log2(ns), 1ns .. ~8ms+
+    static constexpr int MAX_DRIVES = 16;
+    static constexpr int BRIDGE_TYPES = 256;   // indexed by SftpRequestType
+    static constexpr int PROF_BANKS = 32;      // covers the --banks limit
+    static constexpr int PROF_PAGES = 256;     // 256-byte PC buckets
+
+    // XIOS dispatch: count one call of `func` that took `ns` nanoseconds
+    void record_xios(uint8_t func, uint64_t ns);
+
+    // Disk: one 128-byte record moved on `drive`
+    void count_disk_read(int drive);
+    void count_disk_write(int drive);
+
+    // Bridge: one request of `type` enqueued
+    void count_bridge_request(uint8_t type);
+
+    // Profiler: one PC sample taken in `bank` at address `pc`
+    void count_pc_sample(uint8_t bank, uint16_t pc);
+
+    // Guest-load gauges pushed by Z80Runner about once a second:
+    // instruction throughput, fraction of poll rounds spent halted, and
+    // the batch size currently in use
+    void set_runner_load(double mips, double halt_ratio, int batch);
+
+    // Load a GENSYS memory map (emitted by tools/gensys.py next to
+    // MPM.SYS) so profile buckets are reported with region names.
+    // Call before the run loop starts - the table is not locked.
+    bool load_symbol_map(const std::string& path);
+
+    // Scoped timer for one XIOS dispatch; records on destruction
+    class XiosScope {
+    public:
+        explicit XiosScope(uint8_t func)
+            : func_(func), start_(std::chrono::steady_clock::now()) {}
+        ~XiosScope() {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start_)
+                          .count();
+            Stats::instance().record_xios(func_, static_cast<uint64_t>(ns));
+        }
+
+    private:
+        uint8_t func_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Render everything as one JSON object (zero-count entries omitted)
+    std::string to_json() const;
+
+private:
+    Stats() = default;
+
+    std::atomic<uint64_t> xios_calls_[XIOS_FUNCS] = {};
+    std::atomic<uint64_t> xios_ns_[XIOS_FUNCS] = {};
+    std::atomic<uint64_t> xios_hist_[XIOS_FUNCS][LAT_BUCKETS] = {};
+    std::atomic<uint64_t> disk_reads_[MAX_DRIVES] = {};
+    std::atomic<uint64_t> disk_writes_[MAX_DRIVES] = {};
+    std::atomic<uint64_t> bridge_requests_[BRIDGE_TYPES] = {};
+    std::atomic<uint64_t> pc_samples_[PROF_BANKS][PROF_PAGES] = {};
+    std::atomic<uint64_t> pc_sample_total_{0};
+
+    // Guest-load gauges (x1000 fixed point keeps the atomics integral)
+    std::atomic<uint64_t> load_mips_x1000_{0};
+    std::atomic<uint64_t> load_halt_x1000_{0};
+    std::atomic<uint64_t> load_batch_{0};
+
+    // GENSYS regions for naming profile buckets (common memory is
+    // bank-independent, so a plain address range suffices)
+    struct MapRegion {
+        std::string name;
+        uint16_t start;
+        uint16_t end;  // inclusive
+    };
+    std::vector<MapRegion> map_regions_;
+    const char* region_name(uint16_t addr) const;
+};
+
+#endif // STATS_H
@@ -0,0 +1,48 @@
+// wakeup.h - Main-loop wakeup for event-driven idle
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// When the Z80 halts with nothing to do, the main loop sleeps here until
+// the next tick deadline instead of spinning. SSH threads notify() after
+// enqueueing console input or an SFTP bridge request so the sleeping main
+// loop services them immediately. Built on a self-pipe rather than a
+// condition variable so the sleep can also watch the shared PollSet fd -
+// a new HTTP or SSH connection wakes the main loop without waiting for
+// the next tick. A notification that arrives before the sleep stays in
+// the pipe, so it is never lost.
+
+#pragma once
+
+#include <chrono>
+
+// instance() resolves through a thread-local pointer (same scheme as
+// ConsoleManager) so each fleet instance sleeps on its own pipe and is
+// woken only by its own sessions; unbound threads get the process-wide
+// default. Per-instance wakeups do not watch the PollSet - listener
+// sockets are serviced by the main thread only.
+class Wakeup {
+public:
+    static Wakeup& instance();
+
+    // Bind this wakeup to the calling thread (fleet mode)
+    void bind_to_thread() { tl_current_ = this; }
+
+    // Wake the main loop (callable from any thread)
+    void notify();
+
+    // Sleep until deadline, notify(), or socket readiness on the shared
+    // PollSet, whichever comes first (main thread only)
+    void wait_until(std::chrono::steady_clock::time_point deadline);
+
+private:
+    Wakeup();
+    ~Wakeup();
+    Wakeup(const Wakeup&) = delete;
+    Wakeup& operator=(const Wakeup&) = delete;
+    friend class EmulatorInstance;  // constructs per-instance wakeups
+
+    static thread_local Wakeup* tl_current_;
+
+    int pipe_rd_ = -1;
+    int pipe_wr_ = -1;
+    bool watch_pollset_ = true;  // cleared for per-instance wakeups
+};
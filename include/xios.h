@@ -64,6 +64,19 @@ constexpr uint8_t XIOS_SFTP_DEBUG   = 0x6D; // Debug trace (C=code)
 constexpr uint8_t XIOS_SFTP_TARGET  = 0x6E; // Debug: report target byte (C=byte)
 constexpr uint8_t XIOS_SFTP_BDOSENT = 0x6F; // Debug: report bdos$entry value (BC=value)
 
+// Multi-sector DMA entries (84H+) - custom for this emulator
+// SETSECCNT sets the record count for the next READM/WRITEM, which move
+// N consecutive 128-byte records to/from the DMA address in one dispatch
+// instead of a SETSEC/SETDMA/READ round trip per record
+constexpr uint8_t XIOS_SETSECCNT = 0x84;  // Set record count (C=count, 0 treated as 1)
+constexpr uint8_t XIOS_READM     = 0x85;  // Read N records starting at track/sector
+constexpr uint8_t XIOS_WRITEM    = 0x86;  // Write N records starting at track/sector
+
+// String console output - moves a whole run of characters into the
+// console queue with one dispatch instead of one CONOUT trap per char
+// (D=console, E=length, HL=buffer; returns count queued in A)
+constexpr uint8_t XIOS_CONOUTS   = 0x87;
+
 // MP/M II flags (set by interrupt handlers)
 constexpr uint8_t FLAG_TICK     = 1;   // System tick (16.67ms)
 constexpr uint8_t FLAG_SECOND   = 2;   // One-second flag
@@ -93,6 +106,23 @@ public:
     // Update DMA target bank (called when bank switching via port 0xE1)
     void update_dma_bank(uint8_t bank) { if (bank != 0) dma_bank_ = bank; }
 
+    // Snapshot of XIOS state for machine save/restore (see Z80Runner).
+    // Plain-old-data mirror of the private members below; atomics are
+    // flattened to bytes
+    struct State {
+        uint16_t xios_base;
+        uint8_t current_disk;
+        uint16_t current_track;
+        uint16_t current_sector;
+        uint16_t dma_addr;
+        uint8_t dma_bank;
+        uint8_t sector_count;
+        uint8_t tick_enabled;
+        uint8_t systeminit_done;
+    };
+    State get_state() const;
+    void set_state(const State& s);
+
 private:
     // BIOS-compatible entries
     void do_boot();
@@ -100,6 +130,7 @@ private:
     void do_const();
     void do_conin();
     void do_conout();
+    void do_conouts();
     void do_home();
     void do_seldsk();
     void do_settrk();
@@ -108,6 +139,9 @@ private:
     void do_read();
     void do_write();
     void do_sectran();
+    void do_setseccnt();
+    void do_readm();
+    void do_writem();
 
     // Extended XIOS entries
     void do_selmemory();
@@ -139,6 +173,7 @@ private:
     uint16_t current_sector_;
     uint16_t dma_addr_;
     uint8_t dma_bank_;          // Target bank for DMA to banked addresses
+    uint8_t sector_count_ = 1;  // Record count for READM/WRITEM
 
     // Clock control
     std::atomic<bool> tick_enabled_;
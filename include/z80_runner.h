@@ -13,6 +13,7 @@
 class qkz80;
 class MpmCpu;
 class BankedMemory;
+class BlockCache;
 class XIOS;
 
 // Z80 emulator runner - runs the CPU and handles timer interrupts
@@ -22,10 +23,31 @@ public:
     Z80Runner();
     ~Z80Runner();
 
+    // Number of 48KB memory banks to create (call before boot_from_disk;
+    // default 8). Must match the memory segments in the GENSYS config or
+    // MP/M II will address banks that were never selected
+    void set_num_banks(int banks) { num_banks_ = banks; }
+
     // Boot from disk sector 0 (cold boot loader)
     // Reads sector 0 from drive A into 0x0000 and starts execution there
     bool boot_from_disk();
 
+    // Fast boot: do the loader's work on the host. Parses the drive A
+    // directory for MPM.SYS, loads it into bank 0 with bulk copies and
+    // starts execution at the XDOS entry - skipping the emulated cold
+    // loader, MPMLDR and LDRBIOS, whose only job is that copy. The
+    // resulting machine state matches what MPMLDR hands over; callers
+    // wanting full boot fidelity keep boot_from_disk()
+    bool fast_boot();
+
+    // Machine snapshots: serialize all memory banks, CPU registers and
+    // XIOS state so a later run can resume at the saved PC instead of
+    // booting through MPMLDR/MPM.SYS. load_snapshot() replaces
+    // boot_from_disk(); disks must already be mounted - only RAM-resident
+    // state lives in the snapshot file
+    bool save_snapshot(const std::string& path) const;
+    bool load_snapshot(const std::string& path);
+
     // Run one batch of instructions (call in main loop)
     // Returns false when should exit (shutdown requested or timeout)
     bool run_polled();
@@ -40,6 +62,10 @@ public:
     MpmCpu* cpu() { return cpu_.get(); }
     BankedMemory* memory() { return memory_.get(); }
     XIOS* xios() { return xios_.get(); }
+    BlockCache* block_cache() { return block_cache_.get(); }
+
+    // Enable hot-block detection/translation cache (call after boot_from_disk)
+    void enable_block_cache();
 
     // Statistics
     uint64_t cycles() const;
@@ -49,10 +75,29 @@ public:
     void set_timeout(int seconds) { timeout_seconds_ = seconds; }
     bool timed_out() const { return timed_out_.load(); }
 
+    // Idle state: true when the CPU is halted and waiting for an interrupt
+    // or external input - the main loop may sleep until next_tick()
+    bool is_idle() const;
+    std::chrono::steady_clock::time_point next_tick() const { return next_tick_; }
+
+    // Turbo mode: deliver the 60Hz tick every TURBO_CYCLES_PER_TICK
+    // emulated cycles instead of every 16.67ms of host time, so the guest
+    // runs as fast as the host allows while MP/M II's dispatcher still
+    // sees a consistent tick rate
+    void set_turbo(bool turbo) { turbo_ = turbo; }
+    bool turbo() const { return turbo_; }
+
+    // PC sampling profiler: record (bank, PC) into Stats at `hz` samples
+    // per second of host time (0 disables). Resolution is one sample per
+    // batch, so rates far above 60Hz shrink the batch size and cost
+    // throughput
+    void set_profile_rate(int hz);
+
 private:
     std::unique_ptr<MpmCpu> cpu_;
     std::unique_ptr<BankedMemory> memory_;
     std::unique_ptr<XIOS> xios_;
+    std::unique_ptr<BlockCache> block_cache_;
 
     std::atomic<bool> running_;
     std::atomic<bool> stop_requested_;
@@ -61,6 +106,42 @@ private:
     std::chrono::steady_clock::time_point next_tick_;
     static constexpr auto TICK_INTERVAL = std::chrono::microseconds(16667);  // 60Hz
 
+    // Batch sizing: running estimate of host instructions/second, used to
+    // convert the time remaining to the next tick into an instruction budget
+    double ips_estimate_ = 10e6;
+    static constexpr int MIN_BATCH = 256;
+    static constexpr int MAX_BATCH = 200000;
+
+    // Turbo mode: virtual tick driven by emulated cycles
+    // (4MHz Z80 at 60Hz = 66667 cycles per tick)
+    bool turbo_ = false;
+    uint64_t next_tick_cycles_ = 0;
+    static constexpr uint64_t TURBO_CYCLES_PER_TICK = 66667;
+    static constexpr int TURBO_BATCH = 10000;
+
+    // Bank count for boot_from_disk (MP/M II default configuration)
+    int num_banks_ = 8;
+
+    // PC sampling profiler
+    int profile_hz_ = 0;
+    std::chrono::microseconds profile_interval_{0};
+    std::chrono::steady_clock::time_point next_sample_;
+
+    // Guest-load reporting window for the /stats "load" gauges: poll
+    // rounds seen, rounds that found the CPU halted, instruction count
+    // at window start, and the last batch size chosen
+    uint64_t polls_ = 0;
+    uint64_t polls_halted_ = 0;
+    uint64_t load_window_instr_ = 0;
+    std::chrono::steady_clock::time_point load_window_start_;
+    int last_batch_ = 0;
+
+    // First-batch timing init and post-boot clock auto-start. Members
+    // rather than function statics so each fleet instance's runner
+    // tracks its own state
+    bool started_ = false;
+    bool clock_auto_started_ = false;
+
     // Counters
     std::atomic<uint64_t> instruction_count_;
 
@@ -69,6 +150,9 @@ private:
     std::chrono::steady_clock::time_point start_time_;
     std::atomic<bool> timed_out_{false};
 
+    // Deliver the 60Hz tick interrupt (and auto-start the clock post-boot)
+    void deliver_tick();
+
     // Boot image file path (optional - if set, load from file instead of disk)
     std::string boot_image_path_;
 };
@@ -0,0 +1,129 @@
+// alog.cpp - Asynchronous logging ring implementation
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "alog.h"
+#include <cstdio>
+
+AsyncLog& AsyncLog::instance() {
+    static AsyncLog log;
+    return log;
+}
+
+AsyncLog::AsyncLog() {
+    // Errors print by default; INFO/DEBUG are opt-in via --trace
+    for (auto& l : level_) {
+        l.store(static_cast<uint8_t>(LogLevel::ERROR),
+                std::memory_order_relaxed);
+    }
+}
+
+void AsyncLog::set_level(LogSubsys subsys, LogLevel level) {
+    level_[static_cast<size_t>(subsys)].store(
+        static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+static bool parse_subsys(const std::string& name, LogSubsys& out) {
+    if (name == "cpu")  { out = LogSubsys::CPU;  return true; }
+    if (name == "xios") { out = LogSubsys::XIOS; return true; }
+    if (name == "disk") { out = LogSubsys::DISK; return true; }
+    if (name == "boot") { out = LogSubsys::BOOT; return true; }
+    return false;
+}
+
+static bool parse_level(const std::string& name, LogLevel& out) {
+    if (name == "none")  { out = LogLevel::NONE;  return true; }
+    if (name == "error") { out = LogLevel::ERROR; return true; }
+    if (name == "info")  { out = LogLevel::INFO;  return true; }
+    if (name == "debug") { out = LogLevel::DEBUG; return true; }
+    return false;
+}
+
+bool AsyncLog::set_levels(const std::string& spec) {
+    size_t pos = 0;
+    while (pos < spec.size()) {
+        size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos) comma = spec.size();
+        std::string item = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) return false;
+
+        LogSubsys subsys;
+        LogLevel level;
+        if (!parse_subsys(item.substr(0, eq), subsys)) return false;
+        if (!parse_level(item.substr(eq + 1), level)) return false;
+        set_level(subsys, level);
+    }
+    return true;
+}
+
+void AsyncLog::write(LogSubsys subsys, LogLevel level, const char* fmt,
+                     unsigned long a0, unsigned long a1, unsigned long a2,
+                     unsigned long a3, unsigned long a4, unsigned long a5) {
+    (void)subsys;
+    (void)level;
+
+    // Claim a slot: CAS the head forward so concurrent producers (main
+    // thread and fleet instance threads) never share a record
+    size_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+        size_t next = (head + 1) & (RING_SIZE - 1);
+        if (next == tail_.load(std::memory_order_acquire)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (head_.compare_exchange_weak(head, next,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    Record& rec = ring_[head];
+    rec.fmt = fmt;
+    rec.args[0] = a0;
+    rec.args[1] = a1;
+    rec.args[2] = a2;
+    rec.args[3] = a3;
+    rec.args[4] = a4;
+    rec.args[5] = a5;
+
+    rec.ready.store(true, std::memory_order_release);
+}
+
+size_t AsyncLog::flush(size_t max_records) {
+    size_t written = 0;
+    size_t tail = tail_.load(std::memory_order_relaxed);
+
+    while (written < max_records &&
+           tail != head_.load(std::memory_order_acquire)) {
+        Record& rec = ring_[tail];
+        // Stop at a slot another producer has claimed but not finished
+        // filling; it will be there on the next flush
+        if (!rec.ready.load(std::memory_order_acquire)) break;
+
+        // Extra arguments beyond what the format consumes are ignored
+        // by fprintf, so every record carries the full set
+        fprintf(stderr, rec.fmt, rec.args[0], rec.args[1], rec.args[2],
+                rec.args[3], rec.args[4], rec.args[5]);
+        fputc('\n', stderr);
+        rec.ready.store(false, std::memory_order_relaxed);
+
+        tail = (tail + 1) & (RING_SIZE - 1);
+        tail_.store(tail, std::memory_order_release);
+        written++;
+    }
+    return written;
+}
+
+void AsyncLog::flush_all() {
+    while (flush(RING_SIZE) > 0) {
+    }
+    uint64_t drops = dropped();
+    if (drops > 0) {
+        fprintf(stderr, "[ALOG] %llu records dropped (ring full)\n",
+                static_cast<unsigned long long>(drops));
+    }
+}
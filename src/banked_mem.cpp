@@ -3,105 +3,125 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "banked_mem.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <stdexcept>
+#include <sys/mman.h>
 
 BankedMemory::BankedMemory(int num_banks)
     : num_banks_(num_banks)
     , current_bank_(0)
 {
-    if (num_banks < 1 || num_banks > 16) {
-        throw std::invalid_argument("num_banks must be 1-16");
+    if (num_banks < 1 || num_banks > 32) {
+        throw std::invalid_argument("num_banks must be 1-32");
     }
 
-    // Allocate banks (each BANK_SIZE)
+    // One contiguous mapping: all banks back-to-back, common at the end.
     // Page 0 (0x0000-0x00FF) is part of each bank, NOT shared.
     // Only interrupt vectors need to be copied to each bank at SYSINIT.
-    banks_.reserve(num_banks);
-    for (int i = 0; i < num_banks; i++) {
-        auto bank = std::make_unique<uint8_t[]>(BANK_SIZE);
-        std::memset(bank.get(), 0, BANK_SIZE);
-        banks_.push_back(std::move(bank));
+    //
+    // Anonymous mmap instead of new[]: pages are zero-filled and only
+    // backed when first written, so untouched banks cost address space
+    // but no resident memory. MAP_NORESERVE (where available) also
+    // keeps large bank counts from charging swap up front.
+    ram_size_ = (size_t)num_banks * BANK_SIZE + COMMON_SIZE;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void* p = mmap(nullptr, ram_size_, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error("cannot map guest memory");
     }
+    ram_ = static_cast<uint8_t*>(p);
 
-    // Allocate high common area (16KB for NUCLEUS layout)
-    common_ = std::make_unique<uint8_t[]>(COMMON_SIZE);
-    std::memset(common_.get(), 0, COMMON_SIZE);
+    bank_base_ = ram_;
+    common_base_ = ram_ + (size_t)num_banks * BANK_SIZE;
 }
 
-qkz80_uint8 BankedMemory::fetch_mem(qkz80_uint16 addr, bool is_instruction) {
-    if (addr >= COMMON_BASE) {
-        // High common area (0xC000-0xFFFF)
-        return common_[addr - COMMON_BASE];
-    } else {
-        // Banked area (0x0000-0xBFFF) - includes page 0
-        return banks_[current_bank_][addr];
-    }
-}
-
-void BankedMemory::store_mem(qkz80_uint16 addr, qkz80_uint8 byte) {
-    if (addr >= COMMON_BASE) {
-        // High common area (0xC000-0xFFFF)
-        common_[addr - COMMON_BASE] = byte;
-    } else {
-        // Banked area (0x0000-0xBFFF) - includes page 0
-        banks_[current_bank_][addr] = byte;
-    }
+BankedMemory::~BankedMemory() {
+    munmap(ram_, ram_size_);
 }
 
 void BankedMemory::select_bank(uint8_t bank) {
     assert(bank < num_banks_ && "select_bank: invalid bank number");
     current_bank_ = bank;
+    bank_base_ = ram_ + (size_t)bank * BANK_SIZE;
 }
 
 uint8_t BankedMemory::read_bank(uint8_t bank, uint16_t addr) const {
     assert(bank < num_banks_ && "read_bank: invalid bank number");
     if (addr >= COMMON_BASE) {
-        return common_[addr - COMMON_BASE];
+        return common_base_[addr - COMMON_BASE];
     }
-    return banks_[bank][addr];
+    return bank_data(bank)[addr];
 }
 
 void BankedMemory::write_bank(uint8_t bank, uint16_t addr, uint8_t byte) {
     assert(bank < num_banks_ && "write_bank: invalid bank number");
     if (addr >= COMMON_BASE) {
-        common_[addr - COMMON_BASE] = byte;
+        common_base_[addr - COMMON_BASE] = byte;
         return;
     }
-    banks_[bank][addr] = byte;
+    bank_data(bank)[addr] = byte;
 }
 
 uint8_t BankedMemory::read_common(uint16_t addr) const {
     assert(addr >= COMMON_BASE && "read_common: address not in common area");
-    return common_[addr - COMMON_BASE];
+    return common_base_[addr - COMMON_BASE];
 }
 
 void BankedMemory::write_common(uint16_t addr, uint8_t byte) {
     assert(addr >= COMMON_BASE && "write_common: address not in common area");
-    common_[addr - COMMON_BASE] = byte;
+    common_base_[addr - COMMON_BASE] = byte;
 }
 
-void BankedMemory::load(uint8_t bank, uint16_t addr, const uint8_t* data, size_t len) {
-    assert(bank < num_banks_ && "load: invalid bank number");
-
-    for (size_t i = 0; i < len; i++) {
-        uint16_t target = addr + i;
-        if (target >= COMMON_BASE) {
-            // Load to high common area
-            common_[target - COMMON_BASE] = data[i];
-        } else {
-            // Load to banked area (includes page 0)
-            banks_[bank][target] = data[i];
-        }
+void BankedMemory::copy_in(uint8_t bank, uint16_t addr, const uint8_t* src, size_t len) {
+    assert(bank < num_banks_ && "copy_in: invalid bank number");
+
+    // Clamp at top of memory (no wraparound)
+    len = std::min(len, static_cast<size_t>(0x10000) - addr);
+
+    if (addr < COMMON_BASE) {
+        // Banked portion (includes page 0)
+        size_t head = std::min(len, static_cast<size_t>(COMMON_BASE - addr));
+        std::memcpy(bank_data(bank) + addr, src, head);
+        src += head;
+        addr += head;
+        len -= head;
+    }
+    if (len > 0) {
+        // High common area
+        std::memcpy(common_base_ + (addr - COMMON_BASE), src, len);
     }
 }
 
+void BankedMemory::copy_out(uint8_t bank, uint16_t addr, uint8_t* dst, size_t len) const {
+    assert(bank < num_banks_ && "copy_out: invalid bank number");
+
+    len = std::min(len, static_cast<size_t>(0x10000) - addr);
+
+    if (addr < COMMON_BASE) {
+        size_t head = std::min(len, static_cast<size_t>(COMMON_BASE - addr));
+        std::memcpy(dst, bank_data(bank) + addr, head);
+        dst += head;
+        addr += head;
+        len -= head;
+    }
+    if (len > 0) {
+        std::memcpy(dst, common_base_ + (addr - COMMON_BASE), len);
+    }
+}
+
+void BankedMemory::load(uint8_t bank, uint16_t addr, const uint8_t* data, size_t len) {
+    copy_in(bank, addr, data, len);
+}
+
 void BankedMemory::load_common(uint16_t addr, const uint8_t* data, size_t len) {
     assert(addr >= COMMON_BASE && "load_common: address not in common area");
 
     uint16_t offset = addr - COMMON_BASE;
-    for (size_t i = 0; i < len && (offset + i) < COMMON_SIZE; i++) {
-        common_[offset + i] = data[i];
-    }
+    std::memcpy(common_base_ + offset,
+                data, std::min(len, static_cast<size_t>(COMMON_SIZE - offset)));
 }
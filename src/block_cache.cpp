@@ -0,0 +1,62 @@
+// block_cache.cpp - Hot basic-block detection and translation cache
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "block_cache.h"
+
+void BlockCache::record_entry(uint8_t bank, uint16_t pc) {
+    if (bank >= MAX_BANKS) return;
+
+    uint32_t k = key(bank, pc);
+
+    // Already promoted? Just bump the execution count.
+    auto it = blocks_.find(k);
+    if (it != blocks_.end()) {
+        it->second.exec_count++;
+        return;
+    }
+
+    // Cold side: direct-mapped counter, collisions evict
+    CounterSlot& slot = counters_[k % COUNTER_SLOTS];
+    if (slot.key != k) {
+        slot.key = k;
+        slot.count = 0;
+    }
+    slot.count++;
+
+    if (slot.count >= HOT_THRESHOLD) {
+        Block block;
+        block.bank = bank;
+        block.pc = pc;
+        block.exec_count = slot.count;
+        block.translated = false;
+        blocks_.emplace(k, block);
+
+        // Watch the page holding the block entry so guest stores into it
+        // (self-modifying code, overlay loads) invalidate the block
+        watch_pages_[bank][pc >> PAGE_SHIFT] = true;
+        slot.count = 0;
+    }
+}
+
+const BlockCache::Block* BlockCache::lookup(uint8_t bank, uint16_t pc) const {
+    auto it = blocks_.find(key(bank, pc));
+    return it != blocks_.end() ? &it->second : nullptr;
+}
+
+void BlockCache::invalidate(uint8_t bank, uint16_t addr) {
+    if (bank >= MAX_BANKS) return;
+    uint16_t page = addr >> PAGE_SHIFT;
+
+    // Erase every cached block whose entry lies in the written page
+    for (auto it = blocks_.begin(); it != blocks_.end(); ) {
+        if (it->second.bank == bank && (it->second.pc >> PAGE_SHIFT) == page) {
+            it = blocks_.erase(it);
+            invalidations_++;
+        } else {
+            ++it;
+        }
+    }
+
+    watch_pages_[bank][page] = false;
+}
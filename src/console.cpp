@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "console.h"
+#include "replay.h"
 #include <iostream>
 #include <cstdlib>
 
@@ -16,7 +17,8 @@ Console::Console(int id)
 uint8_t Console::const_status() {
     // Check if input available - always check queue regardless of connection state
     // (Matches SIMH approach: status based on queue content, not connection flag)
-    return input_queue_.available() > 0 ? 0xFF : 0x00;
+    // ready() is a single relaxed load - this is polled constantly by the TMP
+    return input_queue_.ready() ? 0xFF : 0x00;
 }
 
 uint8_t Console::read_char() {
@@ -38,6 +40,23 @@ void Console::write_char(uint8_t ch) {
     }
 }
 
+size_t Console::write_string(const uint8_t* data, size_t len) {
+    size_t written = output_queue_.write_some(data, len);
+
+    // In local mode AND not connected: also echo to stdout
+    if (local_mode_.load() && !connected_.load()) {
+        std::cout.write(reinterpret_cast<const char*>(data), written);
+        std::cout.flush();
+    }
+    return written;
+}
+
+bool Console::post_input(uint8_t ch) {
+    if (!input_queue_.try_write(ch)) return false;
+    Replay::instance().record_console(static_cast<uint8_t>(id_), ch);
+    return true;
+}
+
 void Console::reset() {
     connected_.store(false);
     // Don't clear queues - preserve pending I/O for next connection
@@ -46,7 +65,10 @@ void Console::reset() {
 
 // ConsoleManager implementation
 
+thread_local ConsoleManager* ConsoleManager::tl_current_ = nullptr;
+
 ConsoleManager& ConsoleManager::instance() {
+    if (tl_current_) return *tl_current_;
     static ConsoleManager instance;
     return instance;
 }
@@ -4,9 +4,14 @@
 
 #include "disk.h"
 #include "banked_mem.h"
+#include "stats.h"
 #include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 Disk::Disk()
     : read_only_(false)
@@ -31,6 +36,89 @@ bool Disk::open(const std::string& path, bool read_only) {
     path_ = path;
     read_only_ = read_only;
 
+    // "base+overlay": copy-on-write mount. The base is mapped read-only
+    // (shared across instances via the page cache); the overlay absorbs
+    // all writes.
+    auto plus = path.find('+');
+    if (plus != std::string::npos && !read_only) {
+        std::string base_path = path.substr(0, plus);
+        std::string ovl_path = path.substr(plus + 1);
+
+        fd_ = ::open(base_path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            std::cerr << "Cannot open base image: " << base_path << "\n";
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd_, &st) != 0 || st.st_size == 0) {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size),
+                       PROT_READ, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            std::cerr << "Overlay mounts need a mappable base image: "
+                      << base_path << "\n";
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        map_ = static_cast<uint8_t*>(p);
+        map_size_ = static_cast<size_t>(st.st_size);
+
+        if (map_size_ >= 8 && std::memcmp(map_, "MPM2SPRS", 8) == 0) {
+            std::cerr << "Overlay base must be a raw image"
+                         " (unpack with mksparse first): " << base_path << "\n";
+            close();
+            return false;
+        }
+
+        if (!open_overlay(ovl_path)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Preferred path: memory-map the image. Sectors are then read by
+    // pointer into the page cache and writes dirty pages instead of
+    // doing a syscall round trip per 512 bytes.
+    fd_ = ::open(path.c_str(), read_only ? O_RDONLY : O_RDWR);
+    if (fd_ < 0 && !read_only) {
+        // Try read-only if read-write failed
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ >= 0) {
+            read_only_ = true;
+        }
+    }
+    if (fd_ >= 0) {
+        struct stat st;
+        if (fstat(fd_, &st) == 0 && st.st_size > 0) {
+            // Sparse container images are detected by magic and take
+            // the pread/pwrite path instead of mmap
+            char magic[8] = {0};
+            if (pread(fd_, magic, sizeof(magic), 0) == sizeof(magic) &&
+                std::memcmp(magic, "MPM2SPRS", 8) == 0) {
+                if (sp_open(path)) return true;
+                ::close(fd_);
+                fd_ = -1;
+                return false;
+            }
+            int prot = PROT_READ | (read_only_ ? 0 : PROT_WRITE);
+            void* p = mmap(nullptr, static_cast<size_t>(st.st_size),
+                           prot, MAP_SHARED, fd_, 0);
+            if (p != MAP_FAILED) {
+                map_ = static_cast<uint8_t*>(p);
+                map_size_ = static_cast<size_t>(st.st_size);
+                return true;
+            }
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    // Fallback: buffered stream I/O
     auto mode = std::ios::binary | std::ios::in;
     if (!read_only) {
         mode |= std::ios::out;
@@ -48,12 +136,218 @@ bool Disk::open(const std::string& path, bool read_only) {
     return file_.is_open();
 }
 
+// Overlay file layout:
+//   24-byte header: magic "MPM2OVLY", u32 version, u32 block size,
+//   u64 base image size (rejects overlays taken against another image)
+//   presence bitmap: one bit per OVL_BLOCK of the base
+//   data region: base-size worth of blocks, OVL_BLOCK-aligned, sparse
+static const char OVL_MAGIC[8] = {'M', 'P', 'M', '2', 'O', 'V', 'L', 'Y'};
+static constexpr uint32_t OVL_VERSION = 1;
+static constexpr size_t OVL_HEADER_SIZE = 24;
+
+bool Disk::open_overlay(const std::string& path) {
+    ovl_blocks_ = (map_size_ + OVL_BLOCK - 1) / OVL_BLOCK;
+    size_t bitmap_bytes = (ovl_blocks_ + 7) / 8;
+    size_t data_off = (OVL_HEADER_SIZE + bitmap_bytes + OVL_BLOCK - 1)
+                      & ~static_cast<size_t>(OVL_BLOCK - 1);
+    size_t total = data_off + ovl_blocks_ * OVL_BLOCK;
+
+    ovl_fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (ovl_fd_ < 0) {
+        std::cerr << "Cannot open overlay file: " << path << "\n";
+        return false;
+    }
+    struct stat st;
+    if (fstat(ovl_fd_, &st) != 0) return false;
+    bool fresh = (st.st_size == 0);
+    if (fresh) {
+        // Size the file up front; unwritten data blocks remain holes
+        if (ftruncate(ovl_fd_, static_cast<off_t>(total)) != 0) {
+            std::cerr << "Cannot size overlay file: " << path << "\n";
+            return false;
+        }
+    } else if (static_cast<size_t>(st.st_size) != total) {
+        std::cerr << "Overlay size mismatch (wrong base image?): " << path << "\n";
+        return false;
+    }
+
+    void* p = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   ovl_fd_, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "Cannot map overlay file: " << path << "\n";
+        return false;
+    }
+    ovl_map_ = static_cast<uint8_t*>(p);
+    ovl_map_size_ = total;
+
+    if (fresh) {
+        std::memcpy(ovl_map_, OVL_MAGIC, sizeof(OVL_MAGIC));
+        uint32_t version = OVL_VERSION;
+        uint32_t block = OVL_BLOCK;
+        uint64_t base_size = map_size_;
+        std::memcpy(ovl_map_ + 8, &version, 4);
+        std::memcpy(ovl_map_ + 12, &block, 4);
+        std::memcpy(ovl_map_ + 16, &base_size, 8);
+    } else {
+        uint32_t version = 0;
+        uint32_t block = 0;
+        uint64_t base_size = 0;
+        std::memcpy(&version, ovl_map_ + 8, 4);
+        std::memcpy(&block, ovl_map_ + 12, 4);
+        std::memcpy(&base_size, ovl_map_ + 16, 8);
+        if (std::memcmp(ovl_map_, OVL_MAGIC, sizeof(OVL_MAGIC)) != 0 ||
+            version != OVL_VERSION || block != OVL_BLOCK ||
+            base_size != map_size_) {
+            std::cerr << "Not a valid overlay for this base image: "
+                      << path << "\n";
+            return false;
+        }
+    }
+
+    ovl_bitmap_ = ovl_map_ + OVL_HEADER_SIZE;
+    ovl_data_ = ovl_map_ + data_off;
+    return true;
+}
+
+uint8_t* Disk::ovl_block_for_write(size_t offset) {
+    size_t block = offset / OVL_BLOCK;
+    if (block >= ovl_blocks_) return nullptr;
+    uint8_t* dst = ovl_data_ + block * OVL_BLOCK;
+    if (!ovl_present(block)) {
+        // Copy-up: populate the whole block from the base so sub-block
+        // writes land on valid surrounding data
+        size_t avail = map_size_ - block * OVL_BLOCK;
+        size_t n = avail < OVL_BLOCK ? avail : OVL_BLOCK;
+        std::memcpy(dst, map_ + block * OVL_BLOCK, n);
+        if (n < OVL_BLOCK) {
+            std::memset(dst + n, 0xE5, OVL_BLOCK - n);
+        }
+        ovl_bitmap_[block >> 3] |= 1 << (block & 7);
+    }
+    return dst;
+}
+
+// Sparse container layout (see tools/mksparse.cpp for the converter):
+//   24-byte header: magic "MPM2SPRS", u32 version, u32 cluster size,
+//   u64 virtual (raw) image size
+//   cluster table: u32 per virtual cluster (0 = unallocated, N = Nth
+//   data cluster)
+//   data region: allocated clusters back to back, cluster-aligned
+static const char SP_MAGIC[8] = {'M', 'P', 'M', '2', 'S', 'P', 'R', 'S'};
+static constexpr uint32_t SP_VERSION = 1;
+static constexpr size_t SP_HEADER_SIZE = 24;
+
+bool Disk::sp_open(const std::string& path) {
+    uint8_t header[SP_HEADER_SIZE];
+    if (pread(fd_, header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        return false;
+    }
+    uint32_t version;
+    std::memcpy(&version, header + 8, 4);
+    std::memcpy(&sp_cluster_size_, header + 12, 4);
+    std::memcpy(&sp_virtual_size_, header + 16, 8);
+    if (version != SP_VERSION || sp_cluster_size_ == 0 ||
+        (sp_cluster_size_ & (sp_cluster_size_ - 1)) != 0 ||
+        sp_cluster_size_ < 512 || sp_virtual_size_ == 0) {
+        std::cerr << "Invalid sparse image header: " << path << "\n";
+        return false;
+    }
+
+    size_t clusters = (sp_virtual_size_ + sp_cluster_size_ - 1) / sp_cluster_size_;
+    sp_table_.resize(clusters);
+    if (pread(fd_, sp_table_.data(), clusters * 4, SP_HEADER_SIZE)
+            != (ssize_t)(clusters * 4)) {
+        std::cerr << "Truncated sparse image table: " << path << "\n";
+        return false;
+    }
+    sp_data_start_ = (SP_HEADER_SIZE + clusters * 4 + sp_cluster_size_ - 1)
+                     & ~static_cast<size_t>(sp_cluster_size_ - 1);
+
+    sp_allocated_ = 0;
+    for (uint32_t entry : sp_table_) {
+        if (entry > sp_allocated_) sp_allocated_ = entry;
+    }
+
+    sparse_ = true;
+    return true;
+}
+
 void Disk::close() {
+    bool had_overlay = (ovl_map_ != nullptr);
+    if (sparse_) {
+        if (!read_only_ && fd_ >= 0) {
+            fsync(fd_);
+        }
+        sparse_ = false;
+        sp_table_.clear();
+        sp_cluster_size_ = 0;
+        sp_virtual_size_ = 0;
+        sp_data_start_ = 0;
+        sp_allocated_ = 0;
+    }
+    if (ovl_map_) {
+        msync(ovl_map_, ovl_map_size_, MS_SYNC);
+        munmap(ovl_map_, ovl_map_size_);
+        ovl_map_ = nullptr;
+        ovl_map_size_ = 0;
+        ovl_bitmap_ = nullptr;
+        ovl_data_ = nullptr;
+        ovl_blocks_ = 0;
+    }
+    if (ovl_fd_ >= 0) {
+        ::close(ovl_fd_);
+        ovl_fd_ = -1;
+    }
+    if (map_) {
+        if (!read_only_ && !had_overlay) {
+            msync(map_, map_size_, MS_SYNC);
+        }
+        munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
     if (file_.is_open()) {
+        write_back_dirty();
+        file_.flush();
         file_.close();
     }
 }
 
+void Disk::flush() {
+    if (sparse_) {
+        if (!read_only_ && fd_ >= 0) {
+            fsync(fd_);
+        }
+        return;
+    }
+    if (ovl_map_) {
+        msync(ovl_map_, ovl_map_size_, MS_ASYNC);
+        return;
+    }
+    if (map_) {
+        if (!read_only_) {
+            msync(map_, map_size_, MS_ASYNC);
+        }
+        return;
+    }
+    if (file_.is_open()) {
+        write_back_dirty();
+        file_.flush();
+    }
+}
+
+void Disk::write_back_dirty() {
+    for (const auto& [offset, data] : dirty_sectors_) {
+        file_.seekp(offset, std::ios::beg);
+        file_.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    dirty_sectors_.clear();
+}
+
 void Disk::set_geometry(uint16_t spt, uint16_t trk, uint16_t sec_size) {
     format_ = DiskFormat::CUSTOM;
     sectors_per_track_ = spt;
@@ -127,14 +421,21 @@ void Disk::set_format(DiskFormat format) {
 }
 
 DiskFormat Disk::detect_format() const {
-    if (!file_.is_open()) return DiskFormat::SSSD_8;
-
-    // Get file size
-    auto& f = const_cast<std::fstream&>(file_);
-    auto pos = f.tellg();
-    f.seekg(0, std::ios::end);
-    size_t size = f.tellg();
-    f.seekg(pos);
+    if (!is_open()) return DiskFormat::SSSD_8;
+
+    // Get file size (virtual size for sparse containers)
+    size_t size;
+    if (sparse_) {
+        size = static_cast<size_t>(sp_virtual_size_);
+    } else if (map_) {
+        size = map_size_;
+    } else {
+        auto& f = const_cast<std::fstream&>(file_);
+        auto pos = f.tellg();
+        f.seekg(0, std::ios::end);
+        size = f.tellg();
+        f.seekg(pos);
+    }
 
     // hd1k: exactly 8MB (8,388,608 bytes)
     if (size == 8388608) {
@@ -166,10 +467,75 @@ size_t Disk::sector_offset() const {
     return offset;
 }
 
+const uint8_t* Disk::sector_ptr(uint16_t track, uint16_t sector) const {
+    if (!map_) return nullptr;
+    size_t offset = (static_cast<size_t>(track) * sectors_per_track_ + sector) * sector_size_;
+    if (offset + sector_size_ > map_size_) return nullptr;
+    if (ovl_map_) {
+        // Data region is dense, so block i sits at byte offset i in it
+        return ovl_present(offset / OVL_BLOCK) ? ovl_data_ + offset
+                                               : map_ + offset;
+    }
+    return map_ + offset;
+}
+
+uint8_t* Disk::sector_ptr_mut(uint16_t track, uint16_t sector) {
+    if (read_only_) return nullptr;
+    if (ovl_map_) {
+        size_t offset = (static_cast<size_t>(track) * sectors_per_track_ + sector) * sector_size_;
+        if (offset + sector_size_ > map_size_) return nullptr;
+        uint8_t* blk = ovl_block_for_write(offset);
+        return blk ? blk + (offset & (OVL_BLOCK - 1)) : nullptr;
+    }
+    return const_cast<uint8_t*>(sector_ptr(track, sector));
+}
+
 int Disk::read_sector(uint8_t* buffer) {
-    if (!file_.is_open()) return 1;
+    if (!is_open()) return 1;
 
     size_t offset = sector_offset();
+
+    if (sparse_) {
+        if (offset + sector_size_ > sp_virtual_size_) {
+            std::memset(buffer, 0xE5, sector_size_);
+            return 0;
+        }
+        uint32_t entry = sp_table_[offset / sp_cluster_size_];
+        if (entry == 0) {
+            // Unallocated cluster: directory-empty filler
+            std::memset(buffer, 0xE5, sector_size_);
+            return 0;
+        }
+        off_t pos = sp_data_start_
+                    + static_cast<off_t>(entry - 1) * sp_cluster_size_
+                    + (offset & (sp_cluster_size_ - 1));
+        if (pread(fd_, buffer, sector_size_, pos) != (ssize_t)sector_size_) {
+            return 1;
+        }
+        return 0;
+    }
+
+    if (map_) {
+        if (offset + sector_size_ > map_size_) {
+            // Beyond end of image - return empty sector
+            std::memset(buffer, 0xE5, sector_size_);
+            return 0;
+        }
+        const uint8_t* src = map_ + offset;
+        if (ovl_map_ && ovl_present(offset / OVL_BLOCK)) {
+            src = ovl_data_ + offset;
+        }
+        std::memcpy(buffer, src, sector_size_);
+        return 0;
+    }
+
+    // Dirty sectors not yet written through take precedence
+    auto it = dirty_sectors_.find(offset);
+    if (it != dirty_sectors_.end()) {
+        std::memcpy(buffer, it->second.data(), sector_size_);
+        return 0;
+    }
+
     file_.seekg(offset, std::ios::beg);
 
     if (!file_.good()) {
@@ -189,20 +555,98 @@ int Disk::read_sector(uint8_t* buffer) {
 }
 
 int Disk::write_sector(const uint8_t* buffer) {
-    if (!file_.is_open()) return 1;
+    if (!is_open()) return 1;
     if (read_only_) return 1;
 
     size_t offset = sector_offset();
-    file_.seekp(offset, std::ios::beg);
-    file_.write(reinterpret_cast<const char*>(buffer), sector_size_);
-    file_.flush();
 
-    return file_.good() ? 0 : 1;
+    if (sparse_) {
+        if (offset + sector_size_ > sp_virtual_size_) return 1;
+        size_t cluster = offset / sp_cluster_size_;
+        uint32_t entry = sp_table_[cluster];
+        if (entry == 0) {
+            // Allocate a fresh cluster at end of file, 0xE5-filled so
+            // the rest of it reads back as before allocation. Data goes
+            // out before the table entry, so a crash between the two
+            // leaves the image consistent.
+            entry = ++sp_allocated_;
+            off_t cpos = sp_data_start_
+                         + static_cast<off_t>(entry - 1) * sp_cluster_size_;
+            std::vector<uint8_t> fill(sp_cluster_size_, 0xE5);
+            if (pwrite(fd_, fill.data(), sp_cluster_size_, cpos)
+                    != (ssize_t)sp_cluster_size_) {
+                --sp_allocated_;
+                return 1;
+            }
+            sp_table_[cluster] = entry;
+            if (pwrite(fd_, &entry, 4, SP_HEADER_SIZE + cluster * 4) != 4) {
+                return 1;
+            }
+        }
+        off_t pos = sp_data_start_
+                    + static_cast<off_t>(entry - 1) * sp_cluster_size_
+                    + (offset & (sp_cluster_size_ - 1));
+        if (pwrite(fd_, buffer, sector_size_, pos) != (ssize_t)sector_size_) {
+            return 1;
+        }
+        if (sync_policy_ == SyncPolicy::ALWAYS) {
+            fsync(fd_);
+        }
+        return 0;
+    }
+
+    if (ovl_map_) {
+        if (offset + sector_size_ > map_size_) return 1;
+        uint8_t* blk = ovl_block_for_write(offset);
+        if (!blk) return 1;
+        std::memcpy(blk + (offset & (OVL_BLOCK - 1)), buffer, sector_size_);
+        if (sync_policy_ == SyncPolicy::ALWAYS) {
+            size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            size_t data_off = (offset / OVL_BLOCK) * OVL_BLOCK
+                              + (ovl_data_ - ovl_map_);
+            size_t start = data_off & ~(page - 1);
+            msync(ovl_map_ + start, data_off + OVL_BLOCK - start, MS_SYNC);
+        }
+        return 0;
+    }
+
+    if (map_) {
+        if (offset + sector_size_ > map_size_) return 1;
+        std::memcpy(map_ + offset, buffer, sector_size_);
+        if (sync_policy_ == SyncPolicy::ALWAYS) {
+            // Write-through: sync the affected page range
+            size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            size_t start = offset & ~(page - 1);
+            size_t end = offset + sector_size_;
+            msync(map_ + start, end - start, MS_SYNC);
+        }
+        // Otherwise: dirty the page; writeback is deferred to flush()/close()
+        return 0;
+    }
+
+    if (sync_policy_ == SyncPolicy::ALWAYS) {
+        file_.seekp(offset, std::ios::beg);
+        file_.write(reinterpret_cast<const char*>(buffer), sector_size_);
+        file_.flush();
+        return file_.good() ? 0 : 1;
+    }
+
+    // Write-back: coalesce into the dirty set; repeated writes to the
+    // same sector (directory updates) collapse to one file write
+    auto& sec = dirty_sectors_[offset];
+    sec.assign(buffer, buffer + sector_size_);
+    if (dirty_sectors_.size() >= DIRTY_LIMIT) {
+        write_back_dirty();
+    }
+    return 0;
 }
 
 // DiskSystem implementation
 
+thread_local DiskSystem* DiskSystem::tl_current_ = nullptr;
+
 DiskSystem& DiskSystem::instance() {
+    if (tl_current_) return *tl_current_;
     static DiskSystem instance;
     return instance;
 }
@@ -218,6 +662,7 @@ bool DiskSystem::mount(int drive, const std::string& path, bool read_only) {
     if (drive < 0 || drive >= MAX_DISKS) return false;
 
     disks_[drive] = std::make_unique<Disk>();
+    disks_[drive]->set_sync_policy(sync_policy_);
     if (!disks_[drive]->open(path, read_only)) {
         disks_[drive].reset();
         return false;
@@ -232,10 +677,27 @@ bool DiskSystem::mount(int drive, const std::string& path, bool read_only) {
 
 void DiskSystem::unmount(int drive) {
     if (drive >= 0 && drive < MAX_DISKS) {
+        // Disk::close() is the write barrier: dirty data is flushed
+        // before the image is released regardless of sync policy
         disks_[drive].reset();
     }
 }
 
+void DiskSystem::set_sync_policy(SyncPolicy policy) {
+    sync_policy_ = policy;
+    for (auto& disk : disks_) {
+        if (disk) disk->set_sync_policy(policy);
+    }
+}
+
+void DiskSystem::flush_all() {
+    for (auto& disk : disks_) {
+        if (disk && !disk->is_read_only()) {
+            disk->flush();
+        }
+    }
+}
+
 Disk* DiskSystem::get(int drive) {
     if (drive < 0 || drive >= MAX_DISKS) return nullptr;
     return disks_[drive].get();
@@ -259,17 +721,14 @@ void DiskSystem::set_sector(uint16_t sector) {
     if (disk) disk->set_sector(sector);
 }
 
-int DiskSystem::read(BankedMemory* mem) {
-    Disk* disk = get(current_drive_);
-    if (!disk || !disk->is_open()) return 1;
-
+int DiskSystem::read_record(Disk* disk, BankedMemory* mem,
+                            uint16_t track, uint16_t logical_sector,
+                            uint16_t dma) {
     // CP/M BIOS operates with 128-byte logical sectors
     // For hd1k: 64 logical sectors/track (128 bytes each) = 8KB/track
     // Physical: 16 sectors/track (512 bytes each) = 8KB/track
     // So logical sector N maps to physical sector N/4, offset (N%4)*128
 
-    uint16_t logical_sector = disk->current_sector();
-    uint16_t track = disk->current_track();
     uint16_t phys_sector_size = disk->sector_size();
 
     // Apply sector skew translation for formats that use it (e.g., ibm-3740)
@@ -280,42 +739,29 @@ int DiskSystem::read(BankedMemory* mem) {
     uint16_t phys_sector = translated_sector / records_per_phys;  // 0-based (disk image is 0-indexed)
     uint16_t offset_in_phys = (translated_sector % records_per_phys) * 128;
 
-    // Temporarily set physical sector for reading
-    disk->set_sector(phys_sector);
+    // Zero-copy path: read straight out of the mapped image
+    const uint8_t* src = disk->sector_ptr(track, phys_sector);
 
     uint8_t buffer[1024];  // Max sector size
-    int result = disk->read_sector(buffer);
-
-    // Restore logical sector (for consistency)
-    disk->set_sector(logical_sector);
-
-    if (result == 0) {
-        // Copy 128 bytes (one CP/M record) to memory at DMA address
-        // Use the target bank for addresses in banked memory
-        for (uint16_t i = 0; i < 128; i++) {
-            uint16_t addr = dma_addr_ + i;
-            if (addr < BankedMemory::COMMON_BASE) {
-                // Banked address - write to the specified target bank
-                mem->write_bank(dma_bank_, addr, buffer[offset_in_phys + i]);
-            } else {
-                // Common area - bank doesn't matter
-                mem->store_mem(addr, buffer[offset_in_phys + i]);
-            }
-        }
+    if (!src) {
+        // Fallback: buffered read (also covers reads past end of image)
+        uint16_t saved_sector = disk->current_sector();
+        disk->set_track(track);
+        disk->set_sector(phys_sector);
+        int result = disk->read_sector(buffer);
+        disk->set_sector(saved_sector);
+        if (result != 0) return result;
+        src = buffer;
     }
 
-    return result;
+    mem->copy_in(dma_bank_, dma, src + offset_in_phys, 128);
+    Stats::instance().count_disk_read(current_drive_);
+    return 0;
 }
 
-int DiskSystem::write(BankedMemory* mem) {
-    Disk* disk = get(current_drive_);
-    if (!disk || !disk->is_open()) return 1;
-
-    // CP/M BIOS operates with 128-byte logical sectors
-    // For writes, we need to read-modify-write the physical sector
-
-    uint16_t logical_sector = disk->current_sector();
-    uint16_t track = disk->current_track();
+int DiskSystem::write_record(Disk* disk, BankedMemory* mem,
+                             uint16_t track, uint16_t logical_sector,
+                             uint16_t dma) {
     uint16_t phys_sector_size = disk->sector_size();
 
     // Apply sector skew translation for formats that use it (e.g., ibm-3740)
@@ -326,34 +772,100 @@ int DiskSystem::write(BankedMemory* mem) {
     uint16_t phys_sector = translated_sector / records_per_phys;  // 0-based (disk image is 0-indexed)
     uint16_t offset_in_phys = (translated_sector % records_per_phys) * 128;
 
+    // Zero-copy path: modify the 128-byte record in the mapped image,
+    // no read-modify-write of the surrounding physical sector needed.
+    // --sync=always forces write-through, so take the buffered path
+    // below which syncs each physical sector.
+    uint8_t* dst = (disk->sync_policy() != SyncPolicy::ALWAYS)
+                       ? disk->sector_ptr_mut(track, phys_sector)
+                       : nullptr;
+    if (dst) {
+        mem->copy_out(dma_bank_, dma, dst + offset_in_phys, 128);
+        Stats::instance().count_disk_write(current_drive_);
+        return 0;
+    }
+
     uint8_t buffer[1024];  // Max sector size
 
-    // Read existing physical sector
+    // Read-modify-write the physical sector
+    uint16_t saved_sector = disk->current_sector();
+    disk->set_track(track);
     disk->set_sector(phys_sector);
     disk->read_sector(buffer);
 
-    // Modify the 128-byte portion
-    // Use the target bank for addresses in banked memory
-    for (uint16_t i = 0; i < 128; i++) {
-        uint16_t addr = dma_addr_ + i;
-        if (addr < BankedMemory::COMMON_BASE) {
-            // Banked address - read from the specified target bank
-            buffer[offset_in_phys + i] = mem->read_bank(dma_bank_, addr);
-        } else {
-            // Common area - bank doesn't matter
-            buffer[offset_in_phys + i] = mem->fetch_mem(addr);
-        }
-    }
+    mem->copy_out(dma_bank_, dma, buffer + offset_in_phys, 128);
 
-    // Write back the physical sector
     int result = disk->write_sector(buffer);
 
     // Restore logical sector
-    disk->set_sector(logical_sector);
+    disk->set_sector(saved_sector);
 
+    if (result == 0) {
+        Stats::instance().count_disk_write(current_drive_);
+    }
     return result;
 }
 
+int DiskSystem::read(BankedMemory* mem) {
+    Disk* disk = get(current_drive_);
+    if (!disk || !disk->is_open()) return 1;
+
+    return read_record(disk, mem, disk->current_track(),
+                       disk->current_sector(), dma_addr_);
+}
+
+int DiskSystem::write(BankedMemory* mem) {
+    Disk* disk = get(current_drive_);
+    if (!disk || !disk->is_open()) return 1;
+
+    return write_record(disk, mem, disk->current_track(),
+                        disk->current_sector(), dma_addr_);
+}
+
+int DiskSystem::read_multi(BankedMemory* mem, int count) {
+    Disk* disk = get(current_drive_);
+    if (!disk || !disk->is_open()) return 1;
+
+    uint16_t track = disk->current_track();
+    uint16_t sector = disk->current_sector();
+    uint16_t dma = dma_addr_;
+    uint16_t records_per_track = disk->dpb().spt;
+
+    for (int n = 0; n < count; n++) {
+        if (sector >= records_per_track) {
+            sector = 0;
+            track++;
+        }
+        int result = read_record(disk, mem, track, sector, dma);
+        if (result != 0) return result;
+        sector++;
+        dma += 128;
+    }
+    return 0;
+}
+
+int DiskSystem::write_multi(BankedMemory* mem, int count) {
+    Disk* disk = get(current_drive_);
+    if (!disk || !disk->is_open()) return 1;
+
+    uint16_t track = disk->current_track();
+    uint16_t sector = disk->current_sector();
+    uint16_t dma = dma_addr_;
+    uint16_t records_per_track = disk->dpb().spt;
+
+    for (int n = 0; n < count; n++) {
+        if (sector >= records_per_track) {
+            sector = 0;
+            track++;
+        }
+        int result = write_record(disk, mem, track, sector, dma);
+        if (result != 0) return result;
+        sector++;
+        dma += 128;
+    }
+    return 0;
+}
+
 uint16_t DiskSystem::translate(uint16_t logical_sector, uint16_t track) {
     // No sector translation - disk images are created without skew
     // using a custom diskdef with skew 0
@@ -5,13 +5,17 @@
 
 #include "http_server.h"
 #include "logger.h"
+#include "poll_set.h"
+#include "stats.h"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <algorithm>
 #include <iostream>
@@ -101,6 +105,7 @@ bool HTTPServer::start(const std::string& host, int port) {
     ListenAddress addr(host, port);
     listeners_.push_back({listen_fd, addr});
     listen_addrs_.push_back(addr);
+    PollSet::instance().add(listen_fd);
     return true;
 }
 
@@ -108,6 +113,7 @@ void HTTPServer::stop() {
     connections_.clear();
     for (auto& listener : listeners_) {
         if (listener.fd >= 0) {
+            PollSet::instance().remove(listener.fd);
             close(listener.fd);
         }
     }
@@ -118,6 +124,10 @@ void HTTPServer::stop() {
 void HTTPServer::poll() {
     if (listeners_.empty()) return;
 
+    // One epoll/kqueue wait covers every listener and connection; the
+    // per-socket handlers below only act on fds in the ready snapshot
+    PollSet::instance().wait(0);
+
     poll_accept();
     poll_connections();
 }
@@ -125,6 +135,8 @@ void HTTPServer::poll() {
 void HTTPServer::poll_accept() {
     // Check all listeners for new connections
     for (auto& listener : listeners_) {
+        if (!PollSet::instance().ready(listener.fd)) continue;
+
         struct sockaddr_storage client_addr;
         socklen_t addr_len = sizeof(client_addr);
 
@@ -171,10 +183,14 @@ void HTTPServer::poll_connections() {
 // ============================================================================
 
 HTTPConnection::HTTPConnection(int fd, const std::string& client_ip)
-    : fd_(fd), client_ip_(client_ip) {}
+    : fd_(fd), client_ip_(client_ip),
+      origin_(SftpBridge::instance().allocate_origin()) {
+    PollSet::instance().add(fd_);
+}
 
 HTTPConnection::~HTTPConnection() {
     if (fd_ >= 0) {
+        PollSet::instance().remove(fd_);
         close(fd_);
     }
 }
@@ -182,6 +198,9 @@ HTTPConnection::~HTTPConnection() {
 bool HTTPConnection::poll() {
     switch (state_) {
         case State::READING_REQUEST:
+            // Only touch the socket when the readiness snapshot says
+            // there is data; bridge-waiting states below poll regardless
+            if (!PollSet::instance().ready(fd_)) return true;
             if (!read_request()) return false;
             if (state_ == State::READING_REQUEST) return true;  // Still reading
             break;
@@ -201,6 +220,11 @@ bool HTTPConnection::poll() {
             if (state_ == State::READING_FILE) return true;  // Still waiting
             break;
 
+        case State::STREAMING_FILE:
+            if (!poll_file_stream()) return false;
+            if (state_ == State::STREAMING_FILE) return true;  // Still streaming
+            break;
+
         case State::SENDING_RESPONSE:
             if (!send_response()) return false;
             if (state_ == State::SENDING_RESPONSE) return true;  // Still sending
@@ -298,6 +322,23 @@ bool HTTPConnection::parse_request() {
         return true;
     }
 
+    // Instrumentation counters (XIOS, disk, bridge) as JSON
+    if (path_ == "/stats") {
+        std::string body = Stats::instance().to_json();
+        std::ostringstream resp;
+        resp << "HTTP/1.0 200 OK\r\n";
+        resp << "Content-Type: application/json\r\n";
+        resp << "Content-Length: " << body.size() << "\r\n";
+        resp << "Connection: close\r\n";
+        resp << "\r\n";
+        if (!is_head_) {
+            resp << body;
+        }
+        response_buffer_ = resp.str();
+        state_ = State::SENDING_RESPONSE;
+        return true;
+    }
+
     std::string p = path_;
     if (p[0] == '/') p = p.substr(1);
 
@@ -396,6 +437,7 @@ void HTTPConnection::start_dir_listing() {
     // Request directory listing from Z80
     SftpRequest req;
     req.type = SftpRequestType::DIR_SEARCH;
+    req.origin = origin_;
     req.drive = parsed_path_.drive;
     req.user = (parsed_path_.user >= 0) ? parsed_path_.user : 0;  // Start with user 0 for all-user search
     req.filename = "*.*";
@@ -455,6 +497,7 @@ bool HTTPConnection::poll_dir_listing() {
         // Request more entries
         SftpRequest req;
         req.type = SftpRequestType::DIR_SEARCH;
+        req.origin = origin_;
         req.drive = parsed_path_.drive;
         req.user = (parsed_path_.user >= 0) ? parsed_path_.user : 0;
         req.filename = "*.*";
@@ -544,6 +587,7 @@ void HTTPConnection::start_file_read() {
     // Open file via RSP bridge
     SftpRequest req;
     req.type = SftpRequestType::FILE_OPEN;
+    req.origin = origin_;
     req.drive = parsed_path_.drive;
     req.user = (parsed_path_.user >= 0) ? parsed_path_.user : 0;  // Default to user 0 for file access
     req.filename = parsed_path_.filename;
@@ -569,14 +613,33 @@ bool HTTPConnection::poll_file_read() {
 
         file_opened_ = true;
 
-        // Now read file content
+        // Now read file content - one streamed request covers the whole
+        // file; the RSP sends MORE_DATA chunks under the same request id
         SftpRequest req;
         req.type = SftpRequestType::FILE_READ;
+        req.origin = origin_;
         req.drive = parsed_path_.drive;
         req.user = (parsed_path_.user >= 0) ? parsed_path_.user : 0;
         req.filename = parsed_path_.filename;
+        req.flags = SFTP_FLAG_STREAM;
 
         pending_request_id_ = SftpBridge::instance().enqueue_request(req);
+
+        // GET streams each bridge chunk straight to the socket with
+        // chunked transfer encoding; HEAD keeps the buffered path since
+        // it must report a Content-Length
+        if (!is_head_) {
+            text_mode_ = is_text_file(parsed_path_.filename);
+            text_eof_ = false;
+            response_buffer_ =
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: " + get_content_type(parsed_path_.filename) + "\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "Connection: close\r\n"
+                "\r\n";
+            response_offset_ = 0;
+            state_ = State::STREAMING_FILE;
+        }
         return true;
     }
 
@@ -589,20 +652,14 @@ bool HTTPConnection::poll_file_read() {
     }
 
     if (more_data && reply->status == SftpReplyStatus::OK) {
-        // Read more
-        SftpRequest req;
-        req.type = SftpRequestType::FILE_READ;
-        req.drive = parsed_path_.drive;
-        req.user = (parsed_path_.user >= 0) ? parsed_path_.user : 0;
-        req.filename = parsed_path_.filename;
-
-        pending_request_id_ = SftpBridge::instance().enqueue_request(req);
+        // More streamed chunks follow under the same request id
         return true;
     }
 
     // Done reading - close file (don't wait for reply)
     SftpRequest close_req;
     close_req.type = SftpRequestType::FILE_CLOSE;
+    close_req.origin = origin_;
     close_req.drive = parsed_path_.drive;
     close_req.user = (parsed_path_.user >= 0) ? parsed_path_.user : 0;
     close_req.filename = parsed_path_.filename;
@@ -614,6 +671,123 @@ bool HTTPConnection::poll_file_read() {
     return true;
 }
 
+void HTTPConnection::queue_stream_chunk(std::vector<uint8_t> data) {
+    if (text_eof_) return;  // past ctrl-Z - discard the rest of the stream
+
+    if (text_mode_) {
+        // Unix line endings: drop CR, stop at the ctrl-Z EOF marker
+        stream_data_.clear();
+        stream_data_.reserve(data.size());
+        for (uint8_t c : data) {
+            if (c == '\r') continue;
+            if (c == 0x1A) { text_eof_ = true; break; }
+            stream_data_.push_back(c);
+        }
+    } else {
+        stream_data_ = std::move(data);
+    }
+
+    if (stream_data_.empty()) return;
+
+    char hdr[16];
+    std::snprintf(hdr, sizeof(hdr), "%zx\r\n", stream_data_.size());
+    stream_hdr_ = hdr;
+    stream_sent_ = 0;
+}
+
+void HTTPConnection::finish_stream() {
+    // Chunked terminator, then close the file via RSP
+    response_buffer_ = "0\r\n\r\n";
+    response_offset_ = 0;
+    stream_finish_ = true;
+
+    SftpRequest close_req;
+    close_req.type = SftpRequestType::FILE_CLOSE;
+    close_req.origin = origin_;
+    close_req.drive = parsed_path_.drive;
+    close_req.user = (parsed_path_.user >= 0) ? parsed_path_.user : 0;
+    close_req.filename = parsed_path_.filename;
+    SftpBridge::instance().enqueue_request(close_req);
+    // Don't wait for close reply
+}
+
+bool HTTPConnection::poll_file_stream() {
+    // Flush header (or terminator) bytes first
+    while (response_offset_ < response_buffer_.size()) {
+        ssize_t n = write(fd_, response_buffer_.data() + response_offset_,
+                          response_buffer_.size() - response_offset_);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            std::cerr << "[HTTP] write() failed: " << strerror(errno) << "\n";
+            state_ = State::DONE;
+            return false;
+        }
+        response_offset_ += n;
+    }
+
+    if (stream_finish_) {
+        state_ = State::DONE;
+        return false;
+    }
+
+    // Push out the current chunk - size line, payload straight from the
+    // bridge reply, CRLF trailer in one writev, resumed on partial writes
+    while (!stream_hdr_.empty()) {
+        size_t total = stream_hdr_.size() + stream_data_.size() + 2;
+        size_t off = stream_sent_;
+        struct iovec iov[3];
+        int iovcnt = 0;
+        auto add_seg = [&](const char* base, size_t len) {
+            if (off >= len) { off -= len; return; }
+            iov[iovcnt].iov_base = const_cast<char*>(base) + off;
+            iov[iovcnt].iov_len = len - off;
+            iovcnt++;
+            off = 0;
+        };
+        add_seg(stream_hdr_.data(), stream_hdr_.size());
+        add_seg(reinterpret_cast<const char*>(stream_data_.data()),
+                stream_data_.size());
+        add_seg("\r\n", 2);
+
+        ssize_t n = writev(fd_, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            std::cerr << "[HTTP] writev() failed: " << strerror(errno) << "\n";
+            state_ = State::DONE;
+            return false;
+        }
+        stream_sent_ += n;
+        if (stream_sent_ >= total) {
+            stream_hdr_.clear();
+            stream_data_.clear();
+            stream_sent_ = 0;
+        }
+    }
+
+    if (stream_done_) {
+        finish_stream();
+        return true;
+    }
+
+    // Pull the next bridge chunk (non-blocking - main thread)
+    auto reply = SftpBridge::instance().try_get_reply(pending_request_id_);
+    if (!reply) return true;
+
+    if (!reply->more_data) stream_done_ = true;
+
+    if (reply->status == SftpReplyStatus::OK) {
+        queue_stream_chunk(std::move(reply->data));
+    } else if (reply->status != SftpReplyStatus::ERROR_NOT_FOUND) {
+        // Mid-stream error: the 200 header is already out, so the only
+        // honest signal is a truncated chunked body
+        std::cerr << "[HTTP] stream read error status="
+                  << (int)reply->status << "\n";
+        state_ = State::DONE;
+        return false;
+    }
+    return true;
+}
+
 void HTTPConnection::build_file_response() {
     std::string content_type = get_content_type(parsed_path_.filename);
     std::string body;
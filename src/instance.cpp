@@ -0,0 +1,110 @@
+// instance.cpp - Fleet-mode emulator instance
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "instance.h"
+#include <chrono>
+#include <iostream>
+
+// Instance registry, indexed by id. Filled on the main thread before
+// the SSH server starts accepting, read-only afterwards
+static std::vector<EmulatorInstance*> g_instances;
+
+EmulatorInstance::EmulatorInstance(int id,
+                                   std::vector<std::pair<int, std::string>> mounts,
+                                   SyncPolicy sync_policy, int num_banks,
+                                   bool turbo, bool fastboot)
+    : id_(id)
+    , mounts_(std::move(mounts))
+    , sync_policy_(sync_policy)
+    , turbo_(turbo)
+    , fastboot_(fastboot)
+{
+    z80_.set_num_banks(num_banks);
+    // Listener sockets belong to the main thread; this instance's idle
+    // sleep should only wake for its own sessions and tick deadline
+    wakeup_.watch_pollset_ = false;
+
+    if (id_ >= static_cast<int>(g_instances.size())) {
+        g_instances.resize(id_ + 1, nullptr);
+    }
+    g_instances[id_] = this;
+}
+
+EmulatorInstance::~EmulatorInstance() {
+    stop();
+    g_instances[id_] = nullptr;
+}
+
+EmulatorInstance* EmulatorInstance::get(int id) {
+    if (id <= 0 || id >= static_cast<int>(g_instances.size())) {
+        return nullptr;
+    }
+    return g_instances[id];
+}
+
+void EmulatorInstance::bind_to_thread() {
+    consoles_.bind_to_thread();
+    disks_.bind_to_thread();
+    bridge_.bind_to_thread();
+    wakeup_.bind_to_thread();
+}
+
+void EmulatorInstance::start() {
+    thread_ = std::thread(&EmulatorInstance::run, this);
+}
+
+void EmulatorInstance::stop() {
+    stop_requested_ = true;
+    wakeup_.notify();  // break out of an idle sleep
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void EmulatorInstance::run() {
+    // All mounting/booting happens here, after binding, so every
+    // instance() call below resolves to this machine
+    bind_to_thread();
+
+    consoles_.init();
+    disks_.set_sync_policy(sync_policy_);
+    for (const auto& mount : mounts_) {
+        if (!disks_.mount(mount.first, mount.second)) {
+            std::cerr << "[fleet " << id_ << "] failed to mount "
+                      << mount.second << "\n";
+            return;
+        }
+    }
+
+    if (fastboot_ ? !z80_.fast_boot() : !z80_.boot_from_disk()) {
+        std::cerr << "[fleet " << id_ << "] failed to boot from disk\n";
+        return;
+    }
+    if (turbo_) {
+        z80_.set_turbo(true);
+    }
+    std::cerr << "[fleet " << id_ << "] booted\n";
+
+    // Same loop shape as the main thread: run a batch, write back dirty
+    // disk data at most once a second, sleep through idle until the next
+    // tick or a session notification. The AsyncLog ring is drained by
+    // the main thread only
+    auto last_disk_flush = std::chrono::steady_clock::now();
+    while (!stop_requested_) {
+        if (!z80_.run_polled()) break;
+        if (sync_policy_ == SyncPolicy::PERIODIC) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_disk_flush >= std::chrono::seconds(1)) {
+                disks_.flush_all();
+                last_disk_flush = now;
+            }
+        }
+        if (z80_.is_idle() && !z80_.turbo()) {
+            wakeup_.wait_until(z80_.next_tick());
+        }
+    }
+
+    z80_.request_stop();
+    disks_.flush_all();
+}
@@ -4,11 +4,17 @@
 
 #include "console.h"
 #include "z80_runner.h"
+#include "block_cache.h"
 #include "disk.h"
 #include "http_server.h"
+#include "instance.h"
 #include "sftp_bridge.h"
+#include "alog.h"
 #include "logger.h"
 #include "listen_address.h"
+#include "replay.h"
+#include "stats.h"
+#include "wakeup.h"
 
 #if defined(HAVE_LIBSSH) || defined(HAVE_WOLFSSH)
 #include "ssh_session.h"
@@ -78,11 +84,45 @@ void print_usage(const char* prog) {
               << "\n"
               << "Options:\n"
               << "  -d, --disk A:FILE     Mount disk image on drive A-P (required)\n"
+              << "                        A:BASE+OVERLAY mounts BASE read-only with a\n"
+              << "                        copy-on-write overlay file (created on first use)\n"
               << "  -l, --local           Enable local console (output to stdout)\n"
               << "  -t, --timeout SECS    Timeout in seconds for debugging (0 = no timeout)\n"
               << "  -w, --http [IP:]PORT  HTTP server address (default: 8000, 0 to disable)\n"
               << "                        Can be repeated for multiple listeners\n"
               << "  --log FILE            Log file for HTTP/SSH/SFTP access (default: mpm2.log)\n"
+              << "  --hotblocks           Enable hot-block detection/translation cache\n"
+              << "  --turbo               Unthrottled execution: 60Hz ticks by emulated\n"
+              << "                        cycles instead of wall clock (for batch runs)\n"
+              << "  --banks N             Number of 48KB memory banks (default: 8, max 32);\n"
+              << "                        must match the GENSYS memory segment config\n"
+              << "  --sync MODE           Disk write sync: always, periodic or close\n"
+              << "                        (default: periodic)\n"
+              << "  --snapshot-save FILE  Write a machine snapshot on shutdown\n"
+              << "  --snapshot-load FILE  Restore a snapshot instead of booting\n"
+              << "                        (skips MPMLDR - resumes at the saved state)\n"
+              << "  --fastboot            Load MPM.SYS from the host side and start at\n"
+              << "                        the XDOS entry, skipping the emulated loader\n"
+              << "                        chain (default: full boot for fidelity)\n"
+              << "  --record FILE         Record ticks, console input and bridge\n"
+              << "                        requests with instruction-count timestamps\n"
+              << "  --replay FILE         Re-inject a recorded trace at the same\n"
+              << "                        instruction counts, unthrottled (the run must\n"
+              << "                        otherwise match the recording - same disks,\n"
+              << "                        banks and boot mode)\n"
+              << "  --profile HZ          Sample the guest PC at HZ samples/sec;\n"
+              << "                        results appear under /stats as \"profile\"\n"
+              << "  --profile-map FILE    GENSYS memory map (MPM.map from gensys.py)\n"
+              << "                        used to name hot regions in the profile\n"
+              << "  --trace SPEC          Diagnostic levels per subsystem, e.g.\n"
+              << "                        xios=debug,disk=info (subsystems: cpu, xios,\n"
+              << "                        disk, boot; levels: none, error, info, debug)\n"
+              << "  --fleet N             Run N independent emulator instances in one\n"
+              << "                        process (default: 1). Instances 1..N-1 mount\n"
+              << "                        each disk via a per-instance copy-on-write\n"
+              << "                        overlay and run on their own threads; append\n"
+              << "                        \"+N\" to the SSH username to reach instance N.\n"
+              << "                        HTTP and snapshots serve instance 0 only\n"
 #ifdef HAVE_SSH
               << "  -p, --port [IP:]PORT  SSH listen address (default: 2222)\n"
               << "                        Can be repeated for multiple listeners\n"
@@ -112,6 +152,18 @@ int main(int argc, char* argv[]) {
     std::vector<ListenAddress> http_addrs;  // HTTP listen addresses
     std::string log_file = "mpm2.log";
     std::vector<std::pair<int, std::string>> disk_mounts;
+    bool hotblocks = false;
+    bool turbo = false;
+    int num_banks = 8;
+    SyncPolicy sync_policy = SyncPolicy::PERIODIC;
+    std::string snapshot_save;
+    std::string snapshot_load;
+    bool fastboot = false;
+    std::string record_path;
+    std::string replay_path;
+    int profile_hz = 0;
+    std::string profile_map;
+    int fleet = 1;
 #ifdef HAVE_SSH
     std::vector<ListenAddress> ssh_addrs;   // SSH listen addresses
     std::string host_key = "keys/ssh_host_rsa_key";
@@ -127,6 +179,19 @@ int main(int argc, char* argv[]) {
         {"timeout",       required_argument, nullptr, 't'},
         {"http",          required_argument, nullptr, 'w'},
         {"log",           required_argument, nullptr, 'L'},
+        {"hotblocks",     no_argument,       nullptr, 'B'},
+        {"turbo",         no_argument,       nullptr, 'u'},
+        {"banks",         required_argument, nullptr, 'b'},
+        {"sync",          required_argument, nullptr, 'y'},
+        {"snapshot-save", required_argument, nullptr, 'S'},
+        {"snapshot-load", required_argument, nullptr, 'R'},
+        {"fastboot",      no_argument,       nullptr, 'G'},
+        {"record",        required_argument, nullptr, 'c'},
+        {"replay",        required_argument, nullptr, 'e'},
+        {"profile",       required_argument, nullptr, 'P'},
+        {"profile-map",   required_argument, nullptr, 'M'},
+        {"trace",         required_argument, nullptr, 'V'},
+        {"fleet",         required_argument, nullptr, 'F'},
 #ifdef HAVE_SSH
         {"port",          required_argument, nullptr, 'p'},
         {"key",           required_argument, nullptr, 'k'},
@@ -140,9 +205,9 @@ int main(int argc, char* argv[]) {
 
     int opt;
 #ifdef HAVE_SSH
-    const char* optstring = "d:lt:w:L:p:k:a:nTh";
+    const char* optstring = "d:lt:w:L:Bub:y:S:R:Gc:e:P:M:V:F:p:k:a:nTh";
 #else
-    const char* optstring = "d:lt:w:L:h";
+    const char* optstring = "d:lt:w:L:Bub:y:S:R:Gc:e:P:M:V:F:h";
 #endif
     while ((opt = getopt_long(argc, argv, optstring, long_options, nullptr)) != -1) {
         switch (opt) {
@@ -192,6 +257,76 @@ int main(int argc, char* argv[]) {
             case 'L':
                 log_file = optarg;
                 break;
+            case 'B':
+                hotblocks = true;
+                break;
+            case 'u':
+                turbo = true;
+                break;
+            case 'b':
+                num_banks = std::atoi(optarg);
+                if (num_banks < 1 || num_banks > 32) {
+                    std::cerr << "Invalid bank count: " << optarg
+                              << " (expected 1-32)\n";
+                    return 1;
+                }
+                break;
+            case 'y': {
+                std::string mode = optarg;
+                if (mode == "always") {
+                    sync_policy = SyncPolicy::ALWAYS;
+                } else if (mode == "periodic") {
+                    sync_policy = SyncPolicy::PERIODIC;
+                } else if (mode == "close") {
+                    sync_policy = SyncPolicy::CLOSE;
+                } else {
+                    std::cerr << "Invalid sync mode: " << mode
+                              << " (expected always, periodic or close)\n";
+                    return 1;
+                }
+                break;
+            }
+            case 'S':
+                snapshot_save = optarg;
+                break;
+            case 'R':
+                snapshot_load = optarg;
+                break;
+            case 'G':
+                fastboot = true;
+                break;
+            case 'c':
+                record_path = optarg;
+                break;
+            case 'e':
+                replay_path = optarg;
+                break;
+            case 'P':
+                profile_hz = std::atoi(optarg);
+                if (profile_hz < 1 || profile_hz > 100000) {
+                    std::cerr << "Invalid profile rate: " << optarg
+                              << " (expected 1-100000 Hz)\n";
+                    return 1;
+                }
+                break;
+            case 'M':
+                profile_map = optarg;
+                break;
+            case 'F':
+                fleet = std::atoi(optarg);
+                if (fleet < 1 || fleet > 32) {
+                    std::cerr << "Invalid fleet size: " << optarg
+                              << " (expected 1-32)\n";
+                    return 1;
+                }
+                break;
+            case 'V':
+                if (!AsyncLog::instance().set_levels(optarg)) {
+                    std::cerr << "Invalid trace spec: " << optarg
+                              << " (expected subsys=level[,subsys=level...])\n";
+                    return 1;
+                }
+                break;
 #ifdef HAVE_SSH
             case 'p': {
                 auto addr = parse_listen_address(optarg, 2222);
@@ -224,6 +359,22 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Fleet instances are reached over SSH by username; the local
+    // console only ever talks to instance 0
+    if (!record_path.empty() && !replay_path.empty()) {
+        std::cerr << "Error: --record and --replay are mutually exclusive\n";
+        return 1;
+    }
+    if (fleet > 1 && (!record_path.empty() || !replay_path.empty())) {
+        std::cerr << "Error: --record/--replay cover the main-thread machine"
+                  << " only, not --fleet\n";
+        return 1;
+    }
+    if (fleet > 1 && local_console) {
+        std::cerr << "Error: --fleet requires SSH mode (not --local)\n";
+        return 1;
+    }
+
     // Require at least one disk mount
     if (disk_mounts.empty()) {
         std::cerr << "Error: No disk mounted. Use -d A:diskimage to mount a boot disk.\n\n";
@@ -266,6 +417,21 @@ int main(int argc, char* argv[]) {
         std::cout << "Local console enabled on all " << MAX_CONSOLES << " consoles\n";
     }
 
+    // Apply sync policy before mounting so it covers all drives
+    DiskSystem::instance().set_sync_policy(sync_policy);
+
+    // Fleet: instance 0 must not write the shared base images either -
+    // the other instances map them read-only underneath their overlays,
+    // so a direct writable mount here would mutate their base view
+    // mid-run. Rewrite its mounts to a .fleet0 overlay, matching
+    // instances 1..N-1 below
+    if (fleet > 1) {
+        for (auto& mount : disk_mounts) {
+            std::string base = mount.second.substr(0, mount.second.find('+'));
+            mount.second = base + "+" + base + ".fleet0.ovl";
+        }
+    }
+
     // Mount disks
     for (const auto& mount : disk_mounts) {
         if (DiskSystem::instance().mount(mount.first, mount.second)) {
@@ -287,10 +453,16 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    // Initialize Z80 and boot from disk
+    // Initialize Z80: restore a snapshot if given, otherwise cold boot
     Z80Runner z80;
+    z80.set_num_banks(num_banks);
 
-    if (!z80.boot_from_disk()) {
+    if (!snapshot_load.empty()) {
+        if (!z80.load_snapshot(snapshot_load)) {
+            std::cerr << "Failed to load snapshot: " << snapshot_load << "\n";
+            return 1;
+        }
+    } else if (fastboot ? !z80.fast_boot() : !z80.boot_from_disk()) {
         std::cerr << "Failed to boot from disk\n";
         return 1;
     }
@@ -300,6 +472,68 @@ int main(int argc, char* argv[]) {
         z80.set_timeout(timeout_seconds);
     }
 
+    if (hotblocks) {
+        z80.enable_block_cache();
+        std::cout << "Hot-block detection enabled\n";
+    }
+
+    if (turbo) {
+        z80.set_turbo(true);
+        std::cout << "Turbo mode: ticks driven by emulated cycles\n";
+    }
+
+    if (!profile_map.empty()) {
+        Stats::instance().load_symbol_map(profile_map);
+    }
+    if (profile_hz > 0) {
+        z80.set_profile_rate(profile_hz);
+        std::cout << "Profiling guest PC at " << profile_hz << " Hz\n";
+    }
+
+    // Record/replay of nondeterministic inputs (see replay.h). Replay
+    // delivers ticks from the trace and runs unthrottled like turbo
+    if (!record_path.empty() || !replay_path.empty()) {
+        Replay::instance().set_clock([&z80] { return z80.instructions(); });
+    }
+    if (!record_path.empty() && !Replay::instance().start_record(record_path)) {
+        return 1;
+    }
+    if (!replay_path.empty()) {
+        if (!Replay::instance().start_replay(replay_path)) {
+            return 1;
+        }
+        z80.set_turbo(true);
+    }
+
+    // Fleet: spawn instances 1..N-1, each with its own consoles, disks,
+    // bridge and Z80 on a dedicated thread; this thread continues as
+    // instance 0 with the existing loop. Every mount is rewritten to a
+    // per-instance copy-on-write overlay over the shared base image, so
+    // the instances never write into each other's disks (a spec that
+    // already names an overlay gets a per-instance overlay instead).
+    // Instances must all be registered before the SSH server starts
+    // accepting - the registry is not locked
+    std::vector<std::unique_ptr<EmulatorInstance>> fleet_instances;
+    for (int i = 1; i < fleet; i++) {
+        std::vector<std::pair<int, std::string>> inst_mounts;
+        for (const auto& mount : disk_mounts) {
+            std::string base = mount.second.substr(0, mount.second.find('+'));
+            inst_mounts.push_back({mount.first,
+                base + "+" + base + ".fleet" + std::to_string(i) + ".ovl"});
+        }
+        fleet_instances.push_back(std::make_unique<EmulatorInstance>(
+            i, std::move(inst_mounts), sync_policy, num_banks, turbo,
+            fastboot));
+    }
+    for (auto& inst : fleet_instances) {
+        inst->start();
+    }
+    if (fleet > 1) {
+        std::cout << "Fleet mode: " << fleet << " instances"
+                  << " (ssh with username suffix +1.." << (fleet - 1)
+                  << " to reach the others)\n";
+    }
+
     // Apply defaults if no addresses specified
     if (http_addrs.empty()) {
         http_addrs.push_back(ListenAddress("", 8000));  // Default: all interfaces, port 8000
@@ -322,12 +556,6 @@ int main(int argc, char* argv[]) {
             return 1;
         }
     }
-    if (http_enabled) {
-        // Set up Z80 tick callback for SFTP bridge (needed for HTTP file access)
-        SftpBridge::instance().set_z80_tick_callback([&z80]() {
-            z80.run_polled();
-        });
-    }
 
 #ifdef HAVE_SSH
     // Initialize SSH server (skip if using local console)
@@ -368,14 +596,6 @@ int main(int argc, char* argv[]) {
         if (!ssh_server.listen_addresses().empty()) {
             std::cout << "Connect with: ssh -p " << ssh_server.listen_addresses()[0].port << " user@localhost\n";
         }
-
-        // Set up Z80 tick callback for SFTP bridge
-        // This allows wait_for_reply() to run Z80 cycles while waiting
-        // Also poll SSH server so other sessions can be serviced during SFTP ops
-        SftpBridge::instance().set_z80_tick_callback([&z80, &ssh_server]() {
-            ssh_server.poll();  // Service other SSH sessions
-            z80.run_polled();
-        });
     }
 #endif
 
@@ -392,6 +612,18 @@ int main(int argc, char* argv[]) {
     // Main loop
     std::cout << "\nPress Ctrl+C to shutdown\n\n";
 
+    // Periodic write-back: push dirty disk sectors out at most once a
+    // second instead of per BDOS record (see --sync)
+    auto last_disk_flush = std::chrono::steady_clock::now();
+    auto maybe_flush_disks = [&]() {
+        if (sync_policy != SyncPolicy::PERIODIC) return;
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_disk_flush >= std::chrono::seconds(1)) {
+            DiskSystem::instance().flush_all();
+            last_disk_flush = now;
+        }
+    };
+
     if (local_console) {
         // Local console mode - read from stdin and run CPU
         if (setup_raw_terminal()) {
@@ -408,7 +640,7 @@ int main(int argc, char* argv[]) {
                     // Send input to console 3 (first user console)
                     Console* con = ConsoleManager::instance().get(3);
                     if (con && con->is_local()) {
-                        con->input_queue().try_write(static_cast<uint8_t>(ch));
+                        con->post_input(static_cast<uint8_t>(ch));
                     }
                 }
                 // Poll HTTP server
@@ -417,6 +649,8 @@ int main(int argc, char* argv[]) {
                 }
                 // Run CPU
                 if (!z80.run_polled()) break;
+                maybe_flush_disks();
+                AsyncLog::instance().flush(64);
             }
             restore_terminal();
         } else {
@@ -435,7 +669,7 @@ int main(int argc, char* argv[]) {
                         if (ch == '\n') ch = '\r';
                         Console* con = ConsoleManager::instance().get(3);
                         if (con && con->is_local()) {
-                            con->input_queue().try_write(static_cast<uint8_t>(ch));
+                            con->post_input(static_cast<uint8_t>(ch));
                         }
                     }
                 }
@@ -445,6 +679,8 @@ int main(int argc, char* argv[]) {
                 }
                 // Run CPU
                 if (!z80.run_polled()) break;
+                maybe_flush_disks();
+                AsyncLog::instance().flush(64);
             }
         }
     }
@@ -463,6 +699,18 @@ int main(int argc, char* argv[]) {
                 http_server.poll();
             }
             if (!z80.run_polled()) break;
+            maybe_flush_disks();
+            AsyncLog::instance().flush(64);
+
+            // Event-driven idle: when the Z80 is halted, sleep until the
+            // next tick deadline, an SSH-thread notification (console
+            // input, SFTP request), or socket readiness on the shared
+            // PollSet (new connection, request data) instead of spinning
+            // at 100% CPU. Skip while an HTTP request is in flight -
+            // bridge-waiting connections need active polling here.
+            if (z80.is_idle() && !z80.turbo() && http_server.connection_count() == 0) {
+                Wakeup::instance().wait_until(z80.next_tick());
+            }
 
             // Run RSP test after delay if requested (non-blocking)
             if (test_rsp && rsp_test_state < 2) {
@@ -526,13 +774,42 @@ int main(int argc, char* argv[]) {
     }
 
     z80.request_stop();
+
+    if (!snapshot_save.empty()) {
+        if (z80.save_snapshot(snapshot_save)) {
+            std::cout << "Snapshot saved to " << snapshot_save << "\n";
+        } else {
+            std::cerr << "Failed to save snapshot: " << snapshot_save << "\n";
+        }
+    }
+
+    Replay::instance().close();
+
+    // Drain any diagnostics still queued in the log ring
+    AsyncLog::instance().flush_all();
+
+    // Shutdown barrier: push all buffered disk writes to stable storage
+    DiskSystem::instance().flush_all();
+
     http_server.stop();
 
 #ifdef HAVE_SSH
     ssh_server.stop();
 #endif
 
+    // Stop fleet instances after the SSH server so no session thread is
+    // still talking to an instance's bridge; each stop() joins the
+    // instance thread and flushes its disks
+    for (auto& inst : fleet_instances) {
+        inst->stop();
+    }
+
     std::cout << "Z80 executed " << z80.instructions() << " instructions\n";
+    if (hotblocks && z80.block_cache()) {
+        std::cout << "Hot blocks: " << z80.block_cache()->hot_blocks()
+                  << " cached, " << z80.block_cache()->invalidations()
+                  << " invalidations\n";
+    }
     std::cout << "Goodbye!\n";
 
     return 0;
@@ -3,10 +3,10 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "mpm_cpu.h"
+#include "alog.h"
 #include "xios.h"
 #include "banked_mem.h"
-#include <iostream>
-#include <iomanip>
+#include "block_cache.h"
 
 MpmCpu::MpmCpu(qkz80_cpu_mem* memory)
     : qkz80(memory)
@@ -66,7 +66,7 @@ qkz80_uint8 MpmCpu::port_in(qkz80_uint8 port) {
 
 void MpmCpu::handle_xios_dispatch() {
     if (!xios_) {
-        std::cerr << "[XIOS DISPATCH] Error: no XIOS handler set" << std::endl;
+        ALOG(CPU, ERROR, "[XIOS DISPATCH] Error: no XIOS handler set");
         return;
     }
 
@@ -85,7 +85,7 @@ void MpmCpu::handle_xios_dispatch() {
 
 void MpmCpu::handle_bank_select(uint8_t bank) {
     if (!banked_mem_) {
-        std::cerr << "[BANK SELECT] Error: no banked memory set" << std::endl;
+        ALOG(CPU, ERROR, "[BANK SELECT] Error: no banked memory set");
         return;
     }
 
@@ -103,26 +103,60 @@ void MpmCpu::execute(void) {
     qkz80::execute();
 }
 
+int MpmCpu::execute_batch(int n) {
+    if (block_cache_ && block_cache_->enabled()) {
+        return execute_batch_profiled(n);
+    }
+
+    // Tight inner loop - no clock reads, no interrupt polling.
+    // The runner checks interrupts and the tick deadline between batches.
+    int executed = 0;
+    while (executed < n) {
+        qkz80::execute();
+        executed++;
+        if (is_halted()) break;
+    }
+    return executed;
+}
+
+int MpmCpu::execute_batch_profiled(int n) {
+    // Same loop, but track PC to feed the block cache: a backward control
+    // transfer marks a candidate loop head. Blocks that cross the hot
+    // threshold are promoted and dispatch can consult lookup() for a
+    // translation before falling through to the interpreter.
+    int executed = 0;
+    uint16_t prev_pc = regs.PC.get_pair16();
+    while (executed < n) {
+        qkz80::execute();
+        executed++;
+        uint16_t pc = regs.PC.get_pair16();
+        if (pc < prev_pc) {
+            uint8_t bank = banked_mem_ ? banked_mem_->current_bank() : 0;
+            block_cache_->record_entry(bank, pc);
+        }
+        prev_pc = pc;
+        if (is_halted()) break;
+    }
+    return executed;
+}
+
 void MpmCpu::unimplemented_opcode(qkz80_uint8 opcode, qkz80_uint16 pc) {
-    // Encountered an invalid or unimplemented Z80 opcode
-    std::cerr << "\n*** Unimplemented opcode 0x" << std::hex << (int)opcode
-              << " at PC=0x" << pc << std::dec << " ***\n";
-    std::cerr << "    Bank=" << (int)(banked_mem_ ? banked_mem_->current_bank() : 0)
-              << " SP=0x" << std::hex << regs.SP.get_pair16()
-              << " AF=0x" << regs.AF.get_pair16()
-              << std::dec << std::endl;
-
-    // Dump surrounding memory for context
-    std::cerr << "    Memory at PC: ";
-    for (int i = -2; i <= 5; i++) {
-        uint16_t addr = pc + i;
-        uint8_t byte = mem->fetch_mem(addr);
-        if (i == 0) std::cerr << "[";
-        std::cerr << std::hex << std::setfill('0') << std::setw(2) << (int)byte;
-        if (i == 0) std::cerr << "]";
-        std::cerr << " ";
+    // Encountered an invalid or unimplemented Z80 opcode. The CPU halts
+    // afterward, so the records surface at the next main-loop flush
+    ALOG(CPU, ERROR, "*** Unimplemented opcode 0x%lx at PC=0x%lx ***",
+         opcode, pc);
+    ALOG(CPU, ERROR, "    Bank=%lu SP=0x%lx AF=0x%lx",
+         banked_mem_ ? banked_mem_->current_bank() : 0,
+         regs.SP.get_pair16(), regs.AF.get_pair16());
+
+    // Dump surrounding memory for context, packed four bytes per word
+    // ([PC-2..PC+1] then [PC+2..PC+5])
+    unsigned long lo = 0, hi = 0;
+    for (int i = 0; i < 4; i++) {
+        lo = (lo << 8) | mem->fetch_mem(static_cast<uint16_t>(pc - 2 + i));
+        hi = (hi << 8) | mem->fetch_mem(static_cast<uint16_t>(pc + 2 + i));
     }
-    std::cerr << std::dec << std::endl;
+    ALOG(CPU, ERROR, "    Memory at PC-2: %08lx %08lx", lo, hi);
 
     set_halted();
 }
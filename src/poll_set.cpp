@@ -0,0 +1,89 @@
+// poll_set.cpp - Shared socket readiness set implementation
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "poll_set.h"
+#include <algorithm>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <sys/event.h>
+#include <sys/time.h>
+#else
+#include <sys/epoll.h>
+#endif
+
+// Plenty for a handful of listeners plus lingering connections; a full
+// batch just means the rest is picked up on the next (level-triggered) wait
+static constexpr int MAX_EVENTS = 64;
+
+PollSet& PollSet::instance() {
+    static PollSet poll_set;
+    return poll_set;
+}
+
+PollSet::PollSet() {
+#ifdef __APPLE__
+    poll_fd_ = kqueue();
+#else
+    poll_fd_ = epoll_create1(0);
+#endif
+}
+
+PollSet::~PollSet() {
+    if (poll_fd_ >= 0) {
+        close(poll_fd_);
+    }
+}
+
+bool PollSet::add(int fd) {
+    if (poll_fd_ < 0 || fd < 0) return false;
+#ifdef __APPLE__
+    struct kevent ev;
+    EV_SET(&ev, fd, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+    return kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr) == 0;
+#else
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(poll_fd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+#endif
+}
+
+void PollSet::remove(int fd) {
+    if (poll_fd_ < 0 || fd < 0) return;
+#ifdef __APPLE__
+    struct kevent ev;
+    EV_SET(&ev, fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+    kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr);
+#else
+    epoll_ctl(poll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+}
+
+size_t PollSet::wait(int timeout_ms) {
+    ready_fds_.clear();
+    if (poll_fd_ < 0) return 0;
+#ifdef __APPLE__
+    struct kevent events[MAX_EVENTS];
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    int n = kevent(poll_fd_, nullptr, 0, events, MAX_EVENTS, &ts);
+    for (int i = 0; i < n; i++) {
+        ready_fds_.push_back(static_cast<int>(events[i].ident));
+    }
+#else
+    struct epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(poll_fd_, events, MAX_EVENTS, timeout_ms);
+    for (int i = 0; i < n; i++) {
+        ready_fds_.push_back(events[i].data.fd);
+    }
+#endif
+    return ready_fds_.size();
+}
+
+bool PollSet::ready(int fd) const {
+    return std::find(ready_fds_.begin(), ready_fds_.end(), fd) !=
+           ready_fds_.end();
+}
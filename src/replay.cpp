@@ -0,0 +1,246 @@
+// replay.cpp - Deterministic record/replay implementation
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "replay.h"
+#include "console.h"
+#include "sftp_bridge.h"
+#include <cstring>
+#include <iostream>
+
+// Trace file layout, version 1 (all integers little-endian):
+//   8 bytes   magic "MPM2TRAC"
+//   u32       version
+// followed by events:
+//   u8        type (1 = tick, 2 = console input, 3 = bridge request)
+//   u64       instruction count at arrival
+//   u32       payload length
+//   ...       payload
+// Console payload: console id, character. Bridge payload: request type,
+// drive, user, flags, u32 offset, u16 length, two length-prefixed
+// filename strings, then write data to the end of the payload. Request
+// and origin ids are not recorded - the bridge reassigns them on replay.
+static const char TRACE_MAGIC[8] = {'M', 'P', 'M', '2', 'T', 'R', 'A', 'C'};
+static constexpr uint32_t TRACE_VERSION = 1;
+
+static constexpr uint8_t EV_TICK = 1;
+static constexpr uint8_t EV_CONSOLE = 2;
+static constexpr uint8_t EV_BRIDGE = 3;
+
+static void put_u8(std::ofstream& f, uint8_t v) {
+    f.write(reinterpret_cast<const char*>(&v), 1);
+}
+
+static void put_u16(std::ofstream& f, uint16_t v) {
+    put_u8(f, static_cast<uint8_t>(v & 0xFF));
+    put_u8(f, static_cast<uint8_t>(v >> 8));
+}
+
+static void put_u32(std::ofstream& f, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        put_u8(f, static_cast<uint8_t>(v >> (i * 8)));
+    }
+}
+
+static void put_u64(std::ofstream& f, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        put_u8(f, static_cast<uint8_t>(v >> (i * 8)));
+    }
+}
+
+static uint8_t get_u8(std::ifstream& f) {
+    uint8_t v = 0;
+    f.read(reinterpret_cast<char*>(&v), 1);
+    return v;
+}
+
+static uint32_t get_u32(std::ifstream& f) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        v |= static_cast<uint32_t>(get_u8(f)) << (i * 8);
+    }
+    return v;
+}
+
+static uint64_t get_u64(std::ifstream& f) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v |= static_cast<uint64_t>(get_u8(f)) << (i * 8);
+    }
+    return v;
+}
+
+Replay& Replay::instance() {
+    static Replay replay;
+    return replay;
+}
+
+bool Replay::start_record(const std::string& path) {
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        std::cerr << "Cannot open trace file: " << path << "\n";
+        return false;
+    }
+    out_.write(TRACE_MAGIC, 8);
+    put_u32(out_, TRACE_VERSION);
+    mode_ = Mode::RECORD;
+    std::cout << "Recording execution trace to " << path << "\n";
+    return true;
+}
+
+bool Replay::start_replay(const std::string& path) {
+    in_.open(path, std::ios::binary);
+    if (!in_) {
+        std::cerr << "Cannot open trace file: " << path << "\n";
+        return false;
+    }
+    char magic[8];
+    in_.read(magic, 8);
+    uint32_t version = get_u32(in_);
+    if (!in_ || std::memcmp(magic, TRACE_MAGIC, 8) != 0 ||
+        version != TRACE_VERSION) {
+        std::cerr << "Not a version-" << TRACE_VERSION
+                  << " trace file: " << path << "\n";
+        return false;
+    }
+    mode_ = Mode::REPLAY;
+    fetch_next();
+    if (mode_ == Mode::REPLAY) {
+        std::cout << "Replaying execution trace " << path << "\n";
+    }
+    return true;
+}
+
+void Replay::record_tick() {
+    if (mode_ != Mode::RECORD) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    put_u8(out_, EV_TICK);
+    put_u64(out_, clock_ ? clock_() : 0);
+    put_u32(out_, 0);
+    events_recorded_++;
+}
+
+void Replay::record_console(uint8_t console, uint8_t ch) {
+    if (mode_ != Mode::RECORD) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    put_u8(out_, EV_CONSOLE);
+    put_u64(out_, clock_ ? clock_() : 0);
+    put_u32(out_, 2);
+    put_u8(out_, console);
+    put_u8(out_, ch);
+    events_recorded_++;
+}
+
+void Replay::record_bridge(const SftpRequest& req) {
+    if (mode_ != Mode::RECORD) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t len = 1 + 1 + 1 + 1 + 4 + 2
+                 + 2 + req.filename.size()
+                 + 2 + req.new_filename.size()
+                 + req.data.size();
+    put_u8(out_, EV_BRIDGE);
+    put_u64(out_, clock_ ? clock_() : 0);
+    put_u32(out_, len);
+    put_u8(out_, static_cast<uint8_t>(req.type));
+    put_u8(out_, req.drive);
+    put_u8(out_, req.user);
+    put_u8(out_, req.flags);
+    put_u32(out_, req.offset);
+    put_u16(out_, req.length);
+    put_u16(out_, static_cast<uint16_t>(req.filename.size()));
+    out_.write(req.filename.data(), req.filename.size());
+    put_u16(out_, static_cast<uint16_t>(req.new_filename.size()));
+    out_.write(req.new_filename.data(), req.new_filename.size());
+    out_.write(reinterpret_cast<const char*>(req.data.data()),
+               req.data.size());
+    events_recorded_++;
+}
+
+void Replay::fetch_next() {
+    next_type_ = get_u8(in_);
+    next_instr_ = get_u64(in_);
+    uint32_t len = get_u32(in_);
+    if (!in_ || len > 1 << 20) {  // corrupt length guard
+        mode_ = Mode::NONE;
+        std::cout << "Replay complete: " << events_injected_
+                  << " events injected\n";
+        return;
+    }
+    next_payload_.resize(len);
+    in_.read(reinterpret_cast<char*>(next_payload_.data()), len);
+    if (!in_) {
+        mode_ = Mode::NONE;
+        std::cerr << "Truncated trace event - replay stopped after "
+                  << events_injected_ << " events\n";
+    }
+}
+
+int Replay::inject_due(uint64_t instr, bool halted) {
+    if (mode_ != Mode::REPLAY) return 0;
+    if (halted && next_instr_ > instr) {
+        instr = next_instr_;
+    }
+
+    int ticks = 0;
+    while (mode_ == Mode::REPLAY && next_instr_ <= instr) {
+        switch (next_type_) {
+            case EV_TICK:
+                ticks++;
+                break;
+
+            case EV_CONSOLE: {
+                if (next_payload_.size() != 2) break;
+                Console* con = ConsoleManager::instance().get(next_payload_[0]);
+                if (con && !con->input_queue().try_write(next_payload_[1])) {
+                    // Queue full: keep the event pending and retry on
+                    // the next batch boundary
+                    return ticks;
+                }
+                break;
+            }
+
+            case EV_BRIDGE: {
+                const uint8_t* p = next_payload_.data();
+                size_t n = next_payload_.size();
+                if (n < 12) break;
+                SftpRequest req;
+                req.type = static_cast<SftpRequestType>(p[0]);
+                req.drive = p[1];
+                req.user = p[2];
+                req.flags = p[3];
+                req.offset = p[4] | (p[5] << 8) | (p[6] << 16)
+                           | (static_cast<uint32_t>(p[7]) << 24);
+                req.length = static_cast<uint16_t>(p[8] | (p[9] << 8));
+                size_t pos = 10;
+                uint16_t fn_len = static_cast<uint16_t>(p[pos] | (p[pos + 1] << 8));
+                pos += 2;
+                if (pos + fn_len + 2 > n) break;
+                req.filename.assign(reinterpret_cast<const char*>(p + pos), fn_len);
+                pos += fn_len;
+                uint16_t nfn_len = static_cast<uint16_t>(p[pos] | (p[pos + 1] << 8));
+                pos += 2;
+                if (pos + nfn_len > n) break;
+                req.new_filename.assign(reinterpret_cast<const char*>(p + pos),
+                                        nfn_len);
+                pos += nfn_len;
+                req.data.assign(p + pos, p + n);
+                SftpBridge::instance().enqueue_request(std::move(req));
+                break;
+            }
+
+            default:
+                break;  // unknown event type: skip
+        }
+        events_injected_++;
+        fetch_next();
+    }
+    return ticks;
+}
+
+void Replay::close() {
+    if (mode_ == Mode::RECORD) {
+        out_.close();
+        std::cout << "Recorded " << events_recorded_ << " trace events\n";
+    }
+    mode_ = Mode::NONE;
+}
@@ -3,10 +3,16 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "sftp_bridge.h"
+#include "replay.h"
+#include "stats.h"
+#include "wakeup.h"
 #include <cstring>
 #include <algorithm>
 
+thread_local SftpBridge* SftpBridge::tl_current_ = nullptr;
+
 SftpBridge& SftpBridge::instance() {
+    if (tl_current_) return *tl_current_;
     static SftpBridge instance;
     return instance;
 }
@@ -114,11 +120,37 @@ SftpReply SftpReply::deserialize(const uint8_t* buf, size_t buf_size) {
     return reply;
 }
 
-uint32_t SftpBridge::enqueue_request(SftpRequest req) {
+// Bulk data moves in the low-priority class; everything else is
+// metadata that should jump ahead of it
+static bool is_bulk(SftpRequestType type) {
+    return type == SftpRequestType::FILE_READ ||
+           type == SftpRequestType::FILE_WRITE;
+}
+
+uint32_t SftpBridge::allocate_origin() {
     std::lock_guard<std::mutex> lock(mutex_);
-    req.id = next_request_id_++;
-    pending_requests_.push(std::move(req));
-    return req.id;
+    return next_origin_id_++;
+}
+
+uint32_t SftpBridge::enqueue_request(SftpRequest req) {
+    Stats::instance().count_bridge_request(static_cast<uint8_t>(req.type));
+    Replay::instance().record_bridge(req);
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        req.id = next_request_id_++;
+        id = req.id;
+        OriginQueues& q = pending_requests_[req.origin];
+        if (is_bulk(req.type)) {
+            q.bulk.push(std::move(req));
+        } else {
+            q.meta.push(std::move(req));
+        }
+        pending_count_++;
+    }
+    // Wake the main loop if it is sleeping in idle
+    Wakeup::instance().notify();
+    return id;
 }
 
 std::optional<SftpReply> SftpBridge::wait_for_reply(uint32_t request_id,
@@ -184,21 +216,45 @@ std::optional<SftpReply> SftpBridge::try_get_reply(uint32_t request_id) {
 
 bool SftpBridge::has_pending_request() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return !pending_requests_.empty();
+    return pending_count_ > 0;
+}
+
+bool SftpBridge::take_from_class(bool bulk, uint32_t& cursor,
+                                 uint8_t* buf, size_t buf_size) {
+    if (pending_requests_.empty()) return false;
+
+    // Start after the origin served last time, wrapping around
+    auto it = pending_requests_.upper_bound(cursor);
+    for (size_t n = pending_requests_.size(); n > 0; n--) {
+        if (it == pending_requests_.end()) it = pending_requests_.begin();
+
+        std::queue<SftpRequest>& q = bulk ? it->second.bulk : it->second.meta;
+        if (!q.empty()) {
+            cursor = it->first;
+            current_request_ = std::move(q.front());
+            q.pop();
+            pending_count_--;
+            if (it->second.meta.empty() && it->second.bulk.empty()) {
+                pending_requests_.erase(it);
+            }
+            current_request_->serialize(buf, buf_size);
+            return true;
+        }
+        ++it;
+    }
+    return false;
 }
 
 bool SftpBridge::get_request(uint8_t* buf, size_t buf_size) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (pending_requests_.empty()) {
+    if (pending_count_ == 0) {
         return false;
     }
 
-    current_request_ = std::move(pending_requests_.front());
-    pending_requests_.pop();
-
-    current_request_->serialize(buf, buf_size);
-    return true;
+    // Metadata class first, then bulk data
+    if (take_from_class(false, meta_cursor_, buf, buf_size)) return true;
+    return take_from_class(true, bulk_cursor_, buf, buf_size);
 }
 
 void SftpBridge::set_reply(const uint8_t* buf, size_t buf_size) {
@@ -208,10 +264,20 @@ void SftpBridge::set_reply(const uint8_t* buf, size_t buf_size) {
 
     if (current_request_) {
         reply.request_id = current_request_->id;
-        current_request_.reset();
+        // A streaming request stays in flight across its MORE_DATA chunks:
+        // the RSP sends several replies for one get_request, and each must
+        // carry the same request id. Cleared on the final (non-MORE) chunk.
+        bool streaming = (current_request_->flags & SFTP_FLAG_STREAM) != 0;
+        if (!streaming || !reply.more_data) {
+            current_request_.reset();
+        }
     }
 
-    pending_replies_.push(std::move(reply));
+    // Replayed requests have no session waiting on them - dropping the
+    // replies keeps a long replayed transfer from pooling its data here
+    if (!Replay::instance().replaying()) {
+        pending_replies_.push(std::move(reply));
+    }
     reply_cv_.notify_all();
 }
 
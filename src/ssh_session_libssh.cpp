@@ -11,10 +11,13 @@
 #ifdef HAVE_LIBSSH
 
 #include "ssh_session.h"
+#include "instance.h"
 #include "sftp_bridge.h"
 #include "sftp_path.h"
 #include "console.h"
 #include "logger.h"
+#include "wakeup.h"
+#include "poll_set.h"
 #include <libssh/libssh.h>
 #include <libssh/server.h>
 #include <libssh/callbacks.h>
@@ -72,6 +75,7 @@ static int auth_none_callback(ssh_session session, const char* user, void* userd
         if (DEBUG_SSH) std::cerr << "[SSH] auth_none: accepting (no-auth mode)\n";
         std::string ip = get_client_ip(session);
         LOG_SSH(ip, std::string("auth user=") + (user ? user : "") + " method=none");
+        ssh_sess->route_to_instance(user);
         ssh_sess->set_authenticated(true);
         return SSH_AUTH_SUCCESS;
     }
@@ -86,7 +90,6 @@ static int auth_pubkey_callback(ssh_session session, const char* user,
                                 struct ssh_key_struct* pubkey,
                                 char signature_state, void* userdata) {
     (void)session;
-    (void)user;
     SSHSession* ssh_sess = static_cast<SSHSession*>(userdata);
     if (!ssh_sess || !ssh_sess->server()) {
         return SSH_AUTH_DENIED;
@@ -95,6 +98,7 @@ static int auth_pubkey_callback(ssh_session session, const char* user,
     // No auth mode - accept any key
     if (ssh_sess->server()->no_auth()) {
         if (signature_state == SSH_PUBLICKEY_STATE_VALID) {
+            ssh_sess->route_to_instance(user);
             ssh_sess->set_authenticated(true);
             return SSH_AUTH_SUCCESS;
         }
@@ -122,6 +126,7 @@ static int auth_pubkey_callback(ssh_session session, const char* user,
         // Signature verified - grant access
         std::string ip = get_client_ip(session);
         LOG_SSH(ip, std::string("auth user=") + (user ? user : "") + " method=publickey");
+        ssh_sess->route_to_instance(user);
         ssh_sess->set_authenticated(true);
         return SSH_AUTH_SUCCESS;
     }
@@ -270,6 +275,31 @@ void SSHSession::set_authenticated(bool auth) {
     }
 }
 
+void SSHSession::route_to_instance(const char* user) {
+    if (!user) return;
+    std::string name(user);
+    size_t plus = name.rfind('+');
+    if (plus == std::string::npos || plus + 1 >= name.size()) return;
+
+    int id = std::atoi(name.c_str() + plus + 1);
+    EmulatorInstance* inst = EmulatorInstance::get(id);
+    if (!inst) {
+        // Unknown instance (or "+0"): stay on the main-thread machine
+        if (id != 0) {
+            LOG_SSH(client_ip_, "no fleet instance " + std::to_string(id)
+                                + " - using instance 0");
+        }
+        return;
+    }
+
+    // Bind this session thread to the instance's consoles/disks/bridge/
+    // wakeup; the auth callback runs on the session thread, so every
+    // later instance() call here resolves to that machine
+    inst->bind_to_thread();
+    fleet_instance_ = id;
+    LOG_SSH(client_ip_, "routed to fleet instance " + std::to_string(id));
+}
+
 void SSHSession::set_channel(ssh_channel channel) {
     channel_ = channel;
 }
@@ -319,11 +349,14 @@ void SSHSession::setup_console() {
     con->set_connected(true);
     state_ = SSHState::READY;
 
-    // Clear any stale input from previous session, then inject CR to wake up TMP
+    // Drain any stale input from previous session, then inject CR to wake up TMP
     // The CR causes TMP to process an empty command and print a fresh prompt
-    // Essential for reconnection after disconnect while TMP was waiting
-    con->input_queue().clear();
-    con->input_queue().try_write('\r');
+    // Essential for reconnection after disconnect while TMP was waiting.
+    // drain() rather than clear(): this runs on the session thread, the
+    // queue's producer side, and clear() is consumer-only
+    con->input_queue().drain();
+    con->post_input('\r');
+    Wakeup::instance().notify();
 
     if (DEBUG_SSH) std::cerr << "[SSH] New connection on console " << console_id_ << "\n";
 }
@@ -368,6 +401,13 @@ void SSHSession::setup_sftp() {
 
     is_sftp_ = true;
     state_ = SSHState::READY;
+
+    // Bridge requests from this session share one origin id so the
+    // scheduler can interleave sessions fairly. Allocated here rather
+    // than in the constructor (which runs on the accepting thread) so
+    // the id comes from the instance this session was routed to
+    sftp_origin_ = SftpBridge::instance().allocate_origin();
+
     if (DEBUG_SFTP) std::cerr << "[SFTP] SFTP session established\n";
 }
 
@@ -420,8 +460,10 @@ void SSHSession::run() {
     while (!stop_requested_ && state_ != SSHState::CLOSED) {
         // Use ssh_event for polling after key exchange, or add small delay during kex
         if (kex_done_ && event_) {
-            // Use short timeout to allow quick response to I/O
-            int rc = ssh_event_dopoll(event_, 50);  // 50ms timeout
+            // Short timeout for quick response to I/O; shorter still when
+            // aggregated output is waiting so the flush deadline holds
+            int timeout_ms = outbuf_len_ > 0 ? 2 : 50;
+            int rc = ssh_event_dopoll(event_, timeout_ms);
             // Don't log SSH_AGAIN (-2) spam
             if (DEBUG_SSH && rc != SSH_AGAIN) {
                 std::cerr << "[SSH] ssh_event_dopoll returned " << rc
@@ -595,30 +637,153 @@ bool SSHSession::poll_io() {
     if (n > 0) {
         for (int i = 0; i < n; i++) {
             uint8_t ch = static_cast<uint8_t>(buf[i]);
-            con->input_queue().try_write(ch);
+            con->post_input(ch);
         }
+        // Wake the main loop if it is sleeping in idle
+        Wakeup::instance().notify();
     } else if (n == SSH_ERROR) {
         if (DEBUG_SSH) std::cerr << "[SSH] poll_io: ssh_channel_read_nonblocking error: " << ssh_get_error(session_) << "\n";
         state_ = SSHState::CLOSED;
         return false;
     }
 
-    // Write from console output queue -> SSH (batched for efficiency)
-    // Check available window size to avoid blocking or data loss
+    // Gather console output into the aggregation buffer
+    if (outbuf_len_ < OUTBUF_SIZE) {
+        size_t got = con->output_queue().read_some(outbuf_ + outbuf_len_,
+                                                   OUTBUF_SIZE - outbuf_len_);
+        if (got > 0) {
+            if (outbuf_len_ == 0) {
+                outbuf_since_ = std::chrono::steady_clock::now();
+            }
+            outbuf_len_ += got;
+        }
+    }
+
+    // Flush when the buffer is full, the console queue has drained
+    // (interactive echo - don't sit on the last byte), or the deadline
+    // has passed during sustained output
+    if (outbuf_len_ > 0) {
+        bool drained = con->output_queue().empty();
+        bool deadline = std::chrono::steady_clock::now() - outbuf_since_ >=
+                        FLUSH_DEADLINE;
+        if (outbuf_len_ >= OUTBUF_SIZE || drained || deadline) {
+            if (!flush_output()) return false;
+        }
+    }
+
+    return true;
+}
+
+bool SSHSession::flush_output() {
+    if (outbuf_len_ == 0) return true;
+
+    // Respect the channel window to avoid blocking or data loss
     uint32_t window_size = ssh_channel_window_size(channel_);
-    if (window_size > 0) {
-        char outbuf[512];
-        size_t max_write = (window_size < sizeof(outbuf)) ? window_size : sizeof(outbuf);
-        size_t outlen = 0;
-        int ch;
-        while (outlen < max_write && (ch = con->output_queue().try_read()) >= 0) {
-            outbuf[outlen++] = static_cast<char>(ch);
+    size_t len = (window_size < outbuf_len_) ? window_size : outbuf_len_;
+    if (len == 0) return true;  // Window closed - try again next poll
+
+    int wr = ssh_channel_write(channel_, outbuf_, len);
+    if (wr == SSH_ERROR) {
+        if (DEBUG_SSH) std::cerr << "[SSH] flush_output: ssh_channel_write error: "
+                                 << ssh_get_error(session_) << "\n";
+        state_ = SSHState::CLOSED;
+        return false;
+    }
+    if (wr > 0) {
+        outbuf_len_ -= wr;
+        if (outbuf_len_ > 0) {
+            std::memmove(outbuf_, outbuf_ + wr, outbuf_len_);
+            outbuf_since_ = std::chrono::steady_clock::now();
         }
-        if (outlen > 0) {
-            ssh_channel_write(channel_, outbuf, outlen);
+    }
+    return true;
+}
+
+bool SSHSession::pull_read_chunks(OpenFile* file, uint64_t need) {
+    if (file->read_error) return false;
+
+    while (file->read_active) {
+        std::optional<SftpReply> reply;
+        if (file->cached_data.size() >= need) {
+            // Enough data for this READ - just absorb chunks the RSP has
+            // already streamed so the reply queue stays short
+            reply = SftpBridge::instance().try_get_reply(file->read_req_id);
+            if (!reply) return true;
+        } else {
+            reply = SftpBridge::instance().wait_for_reply(file->read_req_id, 10000);
+            if (!reply) {
+                if (DEBUG_SFTP) std::cerr << "[SFTP] READ: stream timeout\n";
+                file->read_error = true;
+                file->read_active = false;
+                return false;
+            }
+        }
+
+        if (!reply->more_data) file->read_active = false;
+
+        if (reply->status == SftpReplyStatus::ERROR_NOT_FOUND) {
+            // Empty file - EOF with no data
+            break;
         }
+        if (reply->status != SftpReplyStatus::OK) {
+            if (DEBUG_SFTP) std::cerr << "[SFTP] READ: stream error status="
+                                      << (int)reply->status << "\n";
+            file->read_error = true;
+            file->read_active = false;
+            return false;
+        }
+
+        file->cached_data.insert(file->cached_data.end(),
+                                 reply->data.begin(), reply->data.end());
+        file->size = file->cached_data.size();
+    }
+    return true;
+}
+
+bool SSHSession::flush_write_chunks(OpenFile* file, bool final_flush) {
+    if (file->write_error) return false;
+
+    // Send full chunks; the partial tail only goes on the final flush
+    // (the RSP pads the last record with ctrl-Z)
+    while (file->cached_data.size() - file->flushed >= FILE_CHUNK ||
+           (final_flush && file->cached_data.size() > file->flushed)) {
+        size_t chunk_len = std::min(FILE_CHUNK,
+                                    file->cached_data.size() - static_cast<size_t>(file->flushed));
+
+        SftpRequest write_req;
+        write_req.type = SftpRequestType::FILE_WRITE;
+        write_req.origin = sftp_origin_;
+        write_req.drive = file->drive;
+        write_req.user = file->user;
+        write_req.filename = file->filename;
+        write_req.offset = file->flushed;
+        write_req.length = chunk_len;
+        write_req.data.assign(
+            file->cached_data.begin() + file->flushed,
+            file->cached_data.begin() + file->flushed + chunk_len);
+
+        file->write_ids.push_back(SftpBridge::instance().enqueue_request(write_req));
+        file->flushed += chunk_len;
     }
 
+    // Reap replies: non-blocking first, then block down to the window
+    // (or to empty on the final flush). Replies arrive in request order.
+    while (!file->write_ids.empty()) {
+        std::optional<SftpReply> reply;
+        if (file->write_ids.size() > WRITE_WINDOW || final_flush) {
+            reply = SftpBridge::instance().wait_for_reply(file->write_ids.front(), 10000);
+        } else {
+            reply = SftpBridge::instance().try_get_reply(file->write_ids.front());
+            if (!reply) break;
+        }
+        file->write_ids.pop_front();
+
+        if (!reply || reply->status != SftpReplyStatus::OK) {
+            if (DEBUG_SFTP) std::cerr << "[SFTP] WRITE: chunk failed\n";
+            file->write_error = true;
+            return false;
+        }
+    }
     return true;
 }
 
@@ -696,6 +861,7 @@ bool SSHSession::poll_sftp() {
                         // Request more entries
                         SftpRequest search_req;
                         search_req.type = SftpRequestType::DIR_SEARCH;
+                        search_req.origin = sftp_origin_;
                         search_req.drive = dir->drive;
                         search_req.user = dir->user;
                         search_req.filename = "*.*";
@@ -821,6 +987,7 @@ bool SSHSession::poll_sftp() {
 
                 SftpRequest search_req;
                 search_req.type = SftpRequestType::DIR_SEARCH;
+                search_req.origin = sftp_origin_;
                 search_req.drive = parsed.drive;
                 search_req.user = (parsed.user >= 0) ? parsed.user : 0;
                 search_req.filename = parsed.filename;
@@ -875,6 +1042,7 @@ bool SSHSession::poll_sftp() {
                 // Start async directory enumeration
                 SftpRequest search_req;
                 search_req.type = SftpRequestType::DIR_SEARCH;
+                search_req.origin = sftp_origin_;
                 search_req.drive = parsed.drive;
                 search_req.user = user;
                 search_req.filename = "*.*";
@@ -988,57 +1156,48 @@ bool SSHSession::poll_sftp() {
                 if (it != open_files_.end()) {
                     OpenFile* file = it->second.get();
 
-                    // If file was opened for writing, flush data to disk
-                    if (file->is_write && !file->cached_data.empty()) {
-                        if (DEBUG_SFTP) std::cerr << "[SFTP] CLOSE: writing " << file->cached_data.size()
-                                  << " bytes to disk\n";
-
-                        // Write data in chunks (max 1920 bytes per RSP request)
-                        constexpr size_t CHUNK_SIZE = 1920;
-                        size_t offset = 0;
-                        bool write_error = false;
-
-                        while (offset < file->cached_data.size() && !write_error) {
-                            size_t chunk_len = std::min(CHUNK_SIZE, file->cached_data.size() - offset);
-
-                            SftpRequest write_req;
-                            write_req.type = SftpRequestType::FILE_WRITE;
-                            write_req.drive = file->drive;
-                            write_req.user = file->user;
-                            write_req.filename = file->filename;
-                            write_req.offset = offset;
-                            write_req.length = chunk_len;
-                            write_req.data.assign(
-                                file->cached_data.begin() + offset,
-                                file->cached_data.begin() + offset + chunk_len);
-
-                            uint32_t req_id = SftpBridge::instance().enqueue_request(write_req);
-                            auto write_reply = SftpBridge::instance().wait_for_reply(req_id, 10000);
-
-                            if (!write_reply || write_reply->status != SftpReplyStatus::OK) {
-                                if (DEBUG_SFTP) std::cerr << "[SFTP] CLOSE: write error at offset " << offset << "\n";
-                                write_error = true;
-                            } else {
-                                offset += chunk_len;
-                                if (DEBUG_SFTP) std::cerr << "[SFTP] CLOSE: wrote " << chunk_len
-                                          << " bytes, total=" << offset << "\n";
-                            }
-                        }
+                    if (file->is_write) {
+                        // Flush the partial tail and wait for all
+                        // in-flight write chunks to complete
+                        if (DEBUG_SFTP) std::cerr << "[SFTP] CLOSE: flushing "
+                                  << (file->cached_data.size() - file->flushed)
+                                  << " buffered bytes, " << file->write_ids.size()
+                                  << " chunks in flight\n";
+                        bool write_ok = flush_write_chunks(file, true);
 
                         // Close file via RSP
                         SftpRequest close_req;
                         close_req.type = SftpRequestType::FILE_CLOSE;
+                        close_req.origin = sftp_origin_;
                         close_req.drive = file->drive;
                         close_req.user = file->user;
                         close_req.filename = file->filename;
                         SftpBridge::instance().enqueue_request(close_req);
                         // Don't wait for close reply
 
-                        if (write_error) {
+                        if (!write_ok) {
                             open_files_.erase(it);
                             rc = sftp_reply_status(msg, SSH_FX_FAILURE, "Write failed");
                             break;
                         }
+                    } else {
+                        // Drain any unconsumed streamed read chunks so
+                        // stale replies don't linger in the bridge
+                        while (file->read_active) {
+                            auto reply = SftpBridge::instance().wait_for_reply(
+                                file->read_req_id, 10000);
+                            if (!reply || !reply->more_data) file->read_active = false;
+                        }
+
+                        // Close file via RSP (read FCB held open for streaming)
+                        SftpRequest close_req;
+                        close_req.type = SftpRequestType::FILE_CLOSE;
+                        close_req.origin = sftp_origin_;
+                        close_req.drive = file->drive;
+                        close_req.user = file->user;
+                        close_req.filename = file->filename;
+                        SftpBridge::instance().enqueue_request(close_req);
+                        // Don't wait for close reply
                     }
 
                     open_files_.erase(it);
@@ -1076,6 +1235,7 @@ bool SSHSession::poll_sftp() {
                 // Check if file exists via DIR_SEARCH
                 SftpRequest search_req;
                 search_req.type = SftpRequestType::DIR_SEARCH;
+                search_req.origin = sftp_origin_;
                 search_req.drive = parsed.drive;
                 search_req.user = parsed.user;
                 search_req.filename = parsed.filename;
@@ -1092,6 +1252,7 @@ bool SSHSession::poll_sftp() {
                     if (DEBUG_SFTP) std::cerr << "[SFTP] OPEN: deleting existing file for truncate\n";
                     SftpRequest del_req;
                     del_req.type = SftpRequestType::FILE_DELETE;
+                    del_req.origin = sftp_origin_;
                     del_req.drive = parsed.drive;
                     del_req.user = parsed.user;
                     del_req.filename = parsed.filename;
@@ -1109,6 +1270,7 @@ bool SSHSession::poll_sftp() {
                     if (DEBUG_SFTP) std::cerr << "[SFTP] OPEN: creating new file\n";
                     SftpRequest create_req;
                     create_req.type = SftpRequestType::FILE_CREATE;
+                    create_req.origin = sftp_origin_;
                     create_req.drive = parsed.drive;
                     create_req.user = parsed.user;
                     create_req.filename = parsed.filename;
@@ -1136,6 +1298,7 @@ bool SSHSession::poll_sftp() {
                 // Open file via RSP bridge
                 SftpRequest open_req;
                 open_req.type = SftpRequestType::FILE_OPEN;
+                open_req.origin = sftp_origin_;
                 open_req.drive = parsed.drive;
                 open_req.user = parsed.user;
                 open_req.filename = parsed.filename;
@@ -1176,6 +1339,7 @@ bool SSHSession::poll_sftp() {
             // Read mode - open existing file and cache contents
             SftpRequest open_req;
             open_req.type = SftpRequestType::FILE_OPEN;
+            open_req.origin = sftp_origin_;
             open_req.drive = parsed.drive;
             open_req.user = parsed.user;
             open_req.filename = parsed.filename;
@@ -1190,80 +1354,36 @@ bool SSHSession::poll_sftp() {
                 break;
             }
 
-            // Read entire file via RSP bridge (batched: up to 1920 bytes at a time)
-            std::vector<uint8_t> file_data;
-            bool read_error = false;
-            bool more_data = true;
-            while (more_data) {
-                SftpRequest read_req;
-                read_req.type = SftpRequestType::FILE_READ;
-                read_req.drive = parsed.drive;
-                read_req.user = parsed.user;
-                read_req.filename = parsed.filename;
-
-                req_id = SftpBridge::instance().enqueue_request(read_req);
-                auto read_reply = SftpBridge::instance().wait_for_reply(req_id, 10000);
-
-                if (!read_reply) {
-                    if (DEBUG_SFTP) std::cerr << "[SFTP] OPEN: read timeout\n";
-                    read_error = true;
-                    break;
-                }
-
-                // Check status and MORE_DATA flag (already parsed by deserialize)
-                more_data = read_reply->more_data;
-
-                if (read_reply->status == SftpReplyStatus::ERROR_NOT_FOUND) {
-                    // EOF reached (no data in first read = file not found/empty)
-                    break;
-                }
-
-                if (read_reply->status != SftpReplyStatus::OK) {
-                    if (DEBUG_SFTP) std::cerr << "[SFTP] OPEN: read error status=" << (int)read_reply->status << "\n";
-                    read_error = true;
-                    break;
-                }
-
-                // Append data (batched read returns up to 1920 bytes)
-                file_data.insert(file_data.end(),
-                                 read_reply->data.begin(),
-                                 read_reply->data.end());
-
-                if (DEBUG_SFTP) std::cerr << "[SFTP] OPEN: read " << read_reply->data.size()
-                          << " bytes, total=" << file_data.size()
-                          << ", more=" << more_data << "\n";
-            }
-
-            // Close file via RSP
-            SftpRequest close_req;
-            close_req.type = SftpRequestType::FILE_CLOSE;
-            close_req.drive = parsed.drive;
-            close_req.user = parsed.user;
-            close_req.filename = parsed.filename;
-            SftpBridge::instance().enqueue_request(close_req);
-            // Don't wait for close reply
-
-            if (read_error) {
-                rc = sftp_reply_status(msg, SSH_FX_FAILURE, "File read error");
-                break;
-            }
-
-            // Create file handle with cached data
+            // Kick off a streamed FILE_READ and return the handle right
+            // away: the RSP sends the file as MORE_DATA chunks that
+            // queue up in the bridge, and each client READ pulls them in
+            // as needed (read-ahead runs while the client consumes).
+            SftpRequest read_req;
+            read_req.type = SftpRequestType::FILE_READ;
+            read_req.origin = sftp_origin_;
+            read_req.drive = parsed.drive;
+            read_req.user = parsed.user;
+            read_req.filename = parsed.filename;
+            read_req.flags = SFTP_FLAG_STREAM;
+            req_id = SftpBridge::instance().enqueue_request(read_req);
+
+            // Create file handle; data arrives incrementally
             auto file = std::make_unique<OpenFile>();
             file->drive = parsed.drive;
             file->user = parsed.user;
             file->filename = parsed.filename;
-            file->size = file_data.size();
+            file->size = 0;
             file->offset = 0;
             file->is_read_only = true;
             file->is_write = false;
             file->file_created = false;
-            file->cached_data = std::move(file_data);
+            file->read_req_id = req_id;
+            file->read_active = true;
 
             void* handle = reinterpret_cast<void*>(next_handle_id_++);
             open_files_[handle] = std::move(file);
 
-            if (DEBUG_SFTP) std::cerr << "[SFTP] OPEN: success, cached " << open_files_[handle]->size << " bytes\n";
+            if (DEBUG_SFTP) std::cerr << "[SFTP] OPEN: success, streaming read started\n";
 
             ssh_string handle_str = ssh_string_new(sizeof(void*));
             ssh_string_fill(handle_str, &handle, sizeof(void*));
@@ -1295,6 +1415,13 @@ bool SSHSession::poll_sftp() {
             if (DEBUG_SFTP) std::cerr << "[SFTP] READ: offset=" << offset << " len=" << len
                       << " cached_size=" << file->cached_data.size() << "\n";
 
+            // Pull streamed chunks until this range is covered (or EOF);
+            // chunks the RSP already pushed are absorbed without blocking
+            if (!pull_read_chunks(file, offset + len)) {
+                rc = sftp_reply_status(msg, SSH_FX_FAILURE, "File read error");
+                break;
+            }
+
             if (offset >= file->cached_data.size()) {
                 rc = sftp_reply_status(msg, SSH_FX_EOF, "End of file");
                 break;
@@ -1343,6 +1470,13 @@ bool SSHSession::poll_sftp() {
 
             if (DEBUG_SFTP) std::cerr << "[SFTP] WRITE: offset=" << offset << " len=" << data_len << "\n";
 
+            // Data already flushed to the RSP cannot be rewritten
+            // (CP/M writes are sequential-only)
+            if (offset < file->flushed) {
+                rc = sftp_reply_status(msg, SSH_FX_FAILURE, "Non-sequential write");
+                break;
+            }
+
             // Expand cached_data if needed and write at offset
             if (offset + data_len > file->cached_data.size()) {
                 file->cached_data.resize(offset + data_len);
@@ -1350,6 +1484,13 @@ bool SSHSession::poll_sftp() {
             std::memcpy(file->cached_data.data() + offset, data_ptr, data_len);
             file->size = file->cached_data.size();
 
+            // Write-behind: push any full chunks to the RSP now so the
+            // transfer overlaps with the client sending more data
+            if (!flush_write_chunks(file, false)) {
+                rc = sftp_reply_status(msg, SSH_FX_FAILURE, "Write failed");
+                break;
+            }
+
             rc = sftp_reply_status(msg, SSH_FX_OK, "OK");
             break;
         }
@@ -1369,6 +1510,7 @@ bool SSHSession::poll_sftp() {
             // Delete file via RSP bridge
             SftpRequest del_req;
             del_req.type = SftpRequestType::FILE_DELETE;
+            del_req.origin = sftp_origin_;
             del_req.drive = parsed.drive;
             del_req.user = parsed.user;
             del_req.filename = parsed.filename;
@@ -1413,6 +1555,7 @@ bool SSHSession::poll_sftp() {
             // Rename file via RSP bridge
             SftpRequest ren_req;
             ren_req.type = SftpRequestType::FILE_RENAME;
+            ren_req.origin = sftp_origin_;
             ren_req.drive = old_parsed.drive;
             ren_req.user = old_parsed.user;
             ren_req.filename = old_parsed.filename;
@@ -1465,6 +1608,7 @@ bool SSHSession::poll_sftp() {
                 // Rename file via RSP bridge
                 SftpRequest ren_req;
                 ren_req.type = SftpRequestType::FILE_RENAME;
+                ren_req.origin = sftp_origin_;
                 ren_req.drive = old_parsed.drive;
                 ren_req.user = old_parsed.user;
                 ren_req.filename = old_parsed.filename;
@@ -1603,10 +1747,12 @@ bool SSHServer::listen(const std::string& host, int port) {
         return false;
     }
 
-    // Set bind socket non-blocking at OS level
+    // Set bind socket non-blocking at OS level and register it with the
+    // shared readiness set so accepts are event-driven
     socket_t bind_fd = ssh_bind_get_fd(sshbind);
     if (bind_fd != SSH_INVALID_SOCKET) {
         set_nonblocking(bind_fd);
+        PollSet::instance().add(bind_fd);
     }
 
     listeners_.push_back({sshbind, addr});
@@ -1621,6 +1767,10 @@ void SSHServer::stop() {
 
     for (auto& listener : listeners_) {
         if (listener.bind) {
+            socket_t bind_fd = ssh_bind_get_fd(listener.bind);
+            if (bind_fd != SSH_INVALID_SOCKET) {
+                PollSet::instance().remove(bind_fd);
+            }
             ssh_bind_free(listener.bind);
         }
     }
@@ -1636,23 +1786,15 @@ void SSHServer::poll() {
 }
 
 void SSHServer::poll_accept() {
-    // Check all listeners for pending connections
+    // One shared readiness wait replaces a select() per listener; only
+    // accept where a connection is actually pending (avoids EAGAIN spam
+    // on macOS with non-blocking sockets)
+    PollSet::instance().wait(0);
+
     for (auto& listener : listeners_) {
-        // Check if a connection is pending before calling accept
-        // This avoids EAGAIN spam on macOS with non-blocking sockets
         socket_t bind_fd = ssh_bind_get_fd(listener.bind);
         if (bind_fd == SSH_INVALID_SOCKET) continue;
-
-        fd_set readfds;
-        FD_ZERO(&readfds);
-        FD_SET(bind_fd, &readfds);
-
-        struct timeval tv = {0, 0};  // No wait - just check
-        int ready = select(bind_fd + 1, &readfds, nullptr, nullptr, &tv);
-        if (ready <= 0) {
-            // No connection pending (ready == 0) or error (ready < 0)
-            continue;
-        }
+        if (!PollSet::instance().ready(bind_fd)) continue;
 
         // Connection is pending - try to accept
         ssh_session session = ssh_new();
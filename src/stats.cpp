@@ -0,0 +1,199 @@
+// stats.cpp - Runtime instrumentation counters implementation
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stats.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+Stats& Stats::instance() {
+    static Stats stats;
+    return stats;
+}
+
+// Histogram bucket = floor(log2(ns)), clamped to the last bucket
+static int latency_bucket(uint64_t ns) {
+    int b = 0;
+    while (ns > 1 && b < Stats::LAT_BUCKETS - 1) {
+        ns >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void Stats::record_xios(uint8_t func, uint64_t ns) {
+    if (func >= XIOS_FUNCS) return;
+    xios_calls_[func].fetch_add(1, std::memory_order_relaxed);
+    xios_ns_[func].fetch_add(ns, std::memory_order_relaxed);
+    xios_hist_[func][latency_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats::count_disk_read(int drive) {
+    if (drive < 0 || drive >= MAX_DRIVES) return;
+    disk_reads_[drive].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats::count_disk_write(int drive) {
+    if (drive < 0 || drive >= MAX_DRIVES) return;
+    disk_writes_[drive].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats::count_bridge_request(uint8_t type) {
+    bridge_requests_[type].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats::count_pc_sample(uint8_t bank, uint16_t pc) {
+    if (bank >= PROF_BANKS) return;
+    pc_samples_[bank][pc >> 8].fetch_add(1, std::memory_order_relaxed);
+    pc_sample_total_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats::set_runner_load(double mips, double halt_ratio, int batch) {
+    load_mips_x1000_.store(static_cast<uint64_t>(mips * 1000),
+                           std::memory_order_relaxed);
+    load_halt_x1000_.store(static_cast<uint64_t>(halt_ratio * 1000),
+                           std::memory_order_relaxed);
+    load_batch_.store(static_cast<uint64_t>(batch), std::memory_order_relaxed);
+}
+
+bool Stats::load_symbol_map(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) {
+        std::cerr << "Cannot open symbol map: " << path << "\n";
+        return false;
+    }
+
+    map_regions_.clear();
+    std::string name;
+    unsigned start, end;
+    while (f >> name >> std::hex >> start >> end) {
+        if (start > 0xFFFF || end > 0xFFFF || end < start) continue;
+        map_regions_.push_back({name, static_cast<uint16_t>(start),
+                                static_cast<uint16_t>(end)});
+    }
+
+    std::cout << "Loaded " << map_regions_.size()
+              << " regions from " << path << "\n";
+    return !map_regions_.empty();
+}
+
+const char* Stats::region_name(uint16_t addr) const {
+    for (const auto& r : map_regions_) {
+        if (addr >= r.start && addr <= r.end) return r.name.c_str();
+    }
+    return nullptr;
+}
+
+std::string Stats::to_json() const {
+    std::ostringstream json;
+    json << "{\n";
+
+    // XIOS dispatch: keyed by function offset (hex, matches the jump
+    // table constants in xios.h); hist buckets are call counts with
+    // latency in [2^i, 2^(i+1)) ns
+    json << "  \"xios\": {";
+    bool first = true;
+    for (int f = 0; f < XIOS_FUNCS; f++) {
+        uint64_t calls = xios_calls_[f].load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+        if (!first) json << ",";
+        first = false;
+        json << "\n    \"0x" << std::hex << f << std::dec << "\": {"
+             << "\"calls\": " << calls
+             << ", \"total_ns\": " << xios_ns_[f].load(std::memory_order_relaxed)
+             << ", \"hist\": [";
+        for (int b = 0; b < LAT_BUCKETS; b++) {
+            if (b) json << ",";
+            json << xios_hist_[f][b].load(std::memory_order_relaxed);
+        }
+        json << "]}";
+    }
+    json << "\n  },\n";
+
+    // Disk: 128-byte records moved per drive
+    json << "  \"disk\": {";
+    first = true;
+    for (int d = 0; d < MAX_DRIVES; d++) {
+        uint64_t reads = disk_reads_[d].load(std::memory_order_relaxed);
+        uint64_t writes = disk_writes_[d].load(std::memory_order_relaxed);
+        if (reads == 0 && writes == 0) continue;
+        if (!first) json << ",";
+        first = false;
+        json << "\n    \"" << static_cast<char>('a' + d) << "\": {"
+             << "\"record_reads\": " << reads
+             << ", \"record_writes\": " << writes << "}";
+    }
+    json << "\n  },\n";
+
+    // Bridge requests by SftpRequestType value
+    static const char* type_names[] = {
+        "dir_search", "file_read", "file_write", "file_delete",
+        "file_create", "file_close", "file_open", "file_rename",
+    };
+    json << "  \"bridge\": {";
+    first = true;
+    for (int t = 0; t < BRIDGE_TYPES; t++) {
+        uint64_t count = bridge_requests_[t].load(std::memory_order_relaxed);
+        if (count == 0) continue;
+        if (!first) json << ",";
+        first = false;
+        json << "\n    \"";
+        if (t < 8) {
+            json << type_names[t];
+        } else if (t == 255) {
+            json << "test";
+        } else {
+            json << t;
+        }
+        json << "\": " << count;
+    }
+    json << "\n  }";
+
+    // Guest load: throughput, halt ratio and batch size as reported by
+    // the runner (omitted until the first reporting window closes)
+    uint64_t batch = load_batch_.load(std::memory_order_relaxed);
+    if (batch > 0) {
+        auto fixed3 = [&json](uint64_t x1000) {
+            json << x1000 / 1000 << "." << std::setw(3) << std::setfill('0')
+                 << x1000 % 1000 << std::setfill(' ');
+        };
+        json << ",\n  \"load\": {\"mips\": ";
+        fixed3(load_mips_x1000_.load(std::memory_order_relaxed));
+        json << ", \"halt_ratio\": ";
+        fixed3(load_halt_x1000_.load(std::memory_order_relaxed));
+        json << ", \"batch\": " << batch << "}";
+    }
+
+    // PC samples: bank and 256-byte page, named via the GENSYS map when
+    // one was loaded (common memory above 0xC000 is the same in every
+    // bank, so the name applies regardless of which bank was selected)
+    uint64_t samples = pc_sample_total_.load(std::memory_order_relaxed);
+    if (samples > 0) {
+        json << ",\n  \"profile\": {\n    \"samples\": " << samples
+             << ",\n    \"hot\": {";
+        first = true;
+        for (int bank = 0; bank < PROF_BANKS; bank++) {
+            for (int page = 0; page < PROF_PAGES; page++) {
+                uint64_t count =
+                    pc_samples_[bank][page].load(std::memory_order_relaxed);
+                if (count == 0) continue;
+                if (!first) json << ",";
+                first = false;
+                uint16_t addr = static_cast<uint16_t>(page << 8);
+                json << "\n      \"" << bank << ":0x" << std::hex
+                     << addr << std::dec << "\": {\"count\": " << count;
+                if (const char* name = region_name(addr)) {
+                    json << ", \"region\": \"" << name << "\"";
+                }
+                json << "}";
+            }
+        }
+        json << "\n    }\n  }";
+    }
+    json << "\n";
+
+    json << "}\n";
+    return json.str();
+}
@@ -0,0 +1,67 @@
+// wakeup.cpp - Main-loop wakeup implementation
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wakeup.h"
+#include "poll_set.h"
+#include <cstdint>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+thread_local Wakeup* Wakeup::tl_current_ = nullptr;
+
+Wakeup& Wakeup::instance() {
+    if (tl_current_) return *tl_current_;
+    static Wakeup wakeup;
+    return wakeup;
+}
+
+Wakeup::Wakeup() {
+    int fds[2];
+    if (pipe(fds) == 0) {
+        pipe_rd_ = fds[0];
+        pipe_wr_ = fds[1];
+        // Non-blocking both ends: notify() must never block a caller
+        // (a full pipe already means a wakeup is pending), and the
+        // drain below must not block the main thread
+        fcntl(pipe_rd_, F_SETFL, O_NONBLOCK);
+        fcntl(pipe_wr_, F_SETFL, O_NONBLOCK);
+    }
+}
+
+Wakeup::~Wakeup() {
+    if (pipe_rd_ >= 0) close(pipe_rd_);
+    if (pipe_wr_ >= 0) close(pipe_wr_);
+}
+
+void Wakeup::notify() {
+    if (pipe_wr_ < 0) return;
+    uint8_t byte = 0;
+    // EAGAIN (pipe full) is fine - the wakeup is already pending
+    (void)!write(pipe_wr_, &byte, 1);
+}
+
+void Wakeup::wait_until(std::chrono::steady_clock::time_point deadline) {
+    auto now = std::chrono::steady_clock::now();
+    if (deadline <= now) return;
+    int timeout_ms = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now)
+            .count()) + 1;
+
+    struct pollfd fds[2];
+    fds[0].fd = pipe_rd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = watch_pollset_ ? PollSet::instance().fd() : -1;
+    fds[1].events = POLLIN;
+    nfds_t nfds = (fds[1].fd >= 0) ? 2 : 1;
+
+    (void)poll(fds, nfds, timeout_ms);
+
+    // Drain pending notifications so the next sleep is not a spurious wake
+    if (pipe_rd_ >= 0) {
+        uint8_t buf[64];
+        while (read(pipe_rd_, buf, sizeof(buf)) > 0) {
+        }
+    }
+}
@@ -3,20 +3,21 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "xios.h"
+#include "alog.h"
 #include "console.h"
 #include "banked_mem.h"
 #include "disk.h"
 #include "sftp_bridge.h"
+#include "stats.h"
 #include "qkz80.h"
 #include <iostream>
 #include <iomanip>
 #include <set>
 
-// Debug output control - set to true to enable verbose debug output
-static constexpr bool DEBUG_BOOT = false;
-static constexpr bool DEBUG_DISK = false;
-static constexpr bool DEBUG_DISK_ERRORS = true;
-static constexpr bool DEBUG_XIOS = false;
+// Debug output goes through the async log ring (alog.h) so tracing can
+// be enabled at runtime (--trace xios=debug,disk=debug,boot=debug)
+// without stalling the dispatch path on terminal I/O. Disk errors are
+// at ERROR level and print by default.
 
 XIOS::XIOS(qkz80* cpu, BankedMemory* mem)
     : cpu_(cpu)
@@ -35,7 +36,35 @@ XIOS::XIOS(qkz80* cpu, BankedMemory* mem)
 // Global flag set when "Bank 7" is displayed
 bool g_boot_display_complete = false;
 
+XIOS::State XIOS::get_state() const {
+    State s;
+    s.xios_base = xios_base_;
+    s.current_disk = current_disk_;
+    s.current_track = current_track_;
+    s.current_sector = current_sector_;
+    s.dma_addr = dma_addr_;
+    s.dma_bank = dma_bank_;
+    s.sector_count = sector_count_;
+    s.tick_enabled = tick_enabled_.load() ? 1 : 0;
+    s.systeminit_done = systeminit_done_.load() ? 1 : 0;
+    return s;
+}
+
+void XIOS::set_state(const State& s) {
+    xios_base_ = s.xios_base;
+    current_disk_ = s.current_disk;
+    current_track_ = s.current_track;
+    current_sector_ = s.current_sector;
+    dma_addr_ = s.dma_addr;
+    dma_bank_ = s.dma_bank;
+    sector_count_ = s.sector_count;
+    tick_enabled_.store(s.tick_enabled != 0);
+    systeminit_done_.store(s.systeminit_done != 0);
+}
+
 void XIOS::handle_port_dispatch(uint8_t func) {
+    Stats::XiosScope xios_scope(func);
+
     static int call_count = 0;
     static int const_count = 0;
     static int post_boot_xios_calls = 0;
@@ -43,7 +72,8 @@ void XIOS::handle_port_dispatch(uint8_t func) {
 
 
     // Trace XIOS calls after SYSTEMINIT (disabled by setting to 0)
-    if (DEBUG_XIOS && systeminit_done_.load() && post_boot_xios_calls < 100) {
+    if (ALOG_ENABLED(XIOS, DEBUG) && systeminit_done_.load() &&
+        post_boot_xios_calls < 100) {
         post_boot_xios_calls++;
         uint16_t pc = cpu_->regs.PC.get_pair16();
         uint16_t sp = cpu_->regs.SP.get_pair16();
@@ -54,26 +84,22 @@ void XIOS::handle_port_dispatch(uint8_t func) {
         uint8_t ret_hi = mem_->read_bank(bank, sp + 1);
         uint16_t ret_addr = ret_lo | (ret_hi << 8);
 
-        std::cerr << "[XIOS] f=" << std::hex << (int)func
-                  << " PC=" << pc << " SP=" << sp
-                  << " ret=" << ret_addr
-                  << " bk=" << std::dec << (int)bank << "\n";
+        ALOG(XIOS, DEBUG, "[XIOS] f=%lx PC=%lx SP=%lx ret=%lx bk=%lu",
+             func, pc, sp, ret_addr, bank);
     }
 
     // After boot display is complete, trace XIOS calls
-    if (DEBUG_XIOS && g_boot_display_complete) {
+    if (ALOG_ENABLED(XIOS, DEBUG) && g_boot_display_complete) {
         post_boot_xios_calls++;
         // Log first 50 non-CONST/CONOUT calls after boot
         if (func != XIOS_CONST && func != XIOS_CONOUT && post_boot_xios_calls <= 100) {
-            uint16_t pc = cpu_->regs.PC.get_pair16();
-            std::cerr << "[POST-BOOT XIOS #" << post_boot_xios_calls << "] func=0x"
-                      << std::hex << (int)func << " PC=0x" << pc << std::dec << std::endl;
+            ALOG(XIOS, DEBUG, "[POST-BOOT XIOS #%lu] func=0x%lx PC=0x%lx",
+                 post_boot_xios_calls, func, cpu_->regs.PC.get_pair16());
         }
         // Log significant CONST polling after boot
         if (func == XIOS_CONST && (const_count == 10000 || const_count == 100000 || const_count == 1000000)) {
-            uint16_t pc = cpu_->regs.PC.get_pair16();
-            std::cerr << "[POST-BOOT CONST #" << const_count << "] PC=0x"
-                      << std::hex << pc << std::dec << std::endl;
+            ALOG(XIOS, DEBUG, "[POST-BOOT CONST #%lu] PC=0x%lx",
+                 const_count, cpu_->regs.PC.get_pair16());
         }
     }
 
@@ -81,10 +107,9 @@ void XIOS::handle_port_dispatch(uint8_t func) {
     if (func == XIOS_CONST) {
         const_count++;
         // Only log significant milestones
-        if (DEBUG_XIOS && (const_count == 100000 || const_count == 1000000)) {
-            uint16_t pc = cpu_->regs.PC.get_pair16();
-            std::cerr << "[CONST poll #" << const_count << "] PC=0x"
-                      << std::hex << pc << std::dec << std::endl;
+        if (const_count == 100000 || const_count == 1000000) {
+            ALOG(XIOS, DEBUG, "[CONST poll #%lu] PC=0x%lx",
+                 const_count, cpu_->regs.PC.get_pair16());
         }
     } else {
         const_count = 0;
@@ -96,6 +121,7 @@ void XIOS::handle_port_dispatch(uint8_t func) {
         case XIOS_CONST:     do_const(); break;
         case XIOS_CONIN:     do_conin(); break;
         case XIOS_CONOUT:    do_conout(); break;
+        case XIOS_CONOUTS:   do_conouts(); break;
         case XIOS_HOME:      do_home(); break;
         case XIOS_SELDSK:    do_seldsk(); break;
         case XIOS_SETTRK:    do_settrk(); break;
@@ -104,6 +130,9 @@ void XIOS::handle_port_dispatch(uint8_t func) {
         case XIOS_READ:      do_read(); break;
         case XIOS_WRITE:     do_write(); break;
         case XIOS_SECTRAN:   do_sectran(); break;
+        case XIOS_SETSECCNT: do_setseccnt(); break;
+        case XIOS_READM:     do_readm(); break;
+        case XIOS_WRITEM:    do_writem(); break;
         case XIOS_SELMEMORY: do_selmemory(); break;
         case XIOS_POLLDEVICE: do_polldevice(); break;
         case XIOS_STARTCLOCK: do_startclock(); break;
@@ -124,96 +153,98 @@ void XIOS::handle_port_dispatch(uint8_t func) {
         case XIOS_SFTP_DEBUG: do_sftp_debug(); break;
         case XIOS_SFTP_TARGET: {
             uint8_t val = cpu_->regs.BC.get_low();
-            std::cerr << "[XIOS] Target byte at jump addr: 0x" << std::hex << (int)val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[XIOS] Target byte at jump addr: 0x%lx", val);
             break;
         }
         case XIOS_SFTP_BDOSENT: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[RSP] bdos$entry = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[RSP] bdos$entry = 0x%lx", val);
             break;
         }
         case 0x70: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[XIOS] HL before JP: 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[XIOS] HL before JP: 0x%lx", val);
             break;
         }
         case 0x71: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[DELAY] RSPBASE points to: 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[DELAY] RSPBASE points to: 0x%lx", val);
             break;
         }
         case 0x72: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[DELAY] bdos$entry = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[DELAY] bdos$entry = 0x%lx", val);
             break;
         }
         case 0x73: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[DELAY] RSPBASE address = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[DELAY] RSPBASE address = 0x%lx", val);
             break;
         }
         case 0x74: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[BDOS] arg1 (BC) = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] arg1 (BC) = 0x%lx", val);
             break;
         }
         case 0x75: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[BDOS] arg2 (DE) = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] arg2 (DE) = 0x%lx", val);
             break;
         }
         case 0x76: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[BDOS] caller PC = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] caller PC = 0x%lx", val);
             break;
         }
         case 0x77: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[RSP] SP = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[RSP] SP = 0x%lx", val);
             break;
         }
         case 0x78: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[RSP] ret_addr = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[RSP] ret_addr = 0x%lx", val);
             break;
         }
         case 0x79: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[BDOS] RSPBASE = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] RSPBASE = 0x%lx", val);
             break;
         }
         case 0x7a: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[BDOS] bdos_entry = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] bdos_entry = 0x%lx", val);
             break;
         }
         case 0x7b: {
             uint8_t val = cpu_->regs.BC.get_low();
-            std::cerr << "[BDOS] (SP+3) = 0x" << std::hex << (int)val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] (SP+3) = 0x%lx", val);
             break;
         }
         case 0x7c: {
             uint8_t val = cpu_->regs.BC.get_low();
-            std::cerr << "[BDOS] (SP+4) = 0x" << std::hex << (int)val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] (SP+4) = 0x%lx", val);
             break;
         }
         case 0x7d: {
             uint8_t val = cpu_->regs.BC.get_low();
-            std::cerr << "[BDOS] (SP+5) = 0x" << std::hex << (int)val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] (SP+5) = 0x%lx", val);
             break;
         }
         case 0x7e: {
             uint8_t val = cpu_->regs.BC.get_low();
-            std::cerr << "[BDOS] func = 0x" << std::hex << (int)val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] func = 0x%lx", val);
             // Save func for FCB dump in 0x7f handler
             last_bdos_func_ = val;
             break;
         }
         case 0x7f: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[BDOS] parm = 0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[BDOS] parm = 0x%lx", val);
             // If this is search first (0x11) or search next (0x12), dump FCB
-            if (last_bdos_func_ == 0x11 || last_bdos_func_ == 0x12) {
+            // (multi-byte dump stays synchronous)
+            if (ALOG_ENABLED(XIOS, DEBUG) &&
+                (last_bdos_func_ == 0x11 || last_bdos_func_ == 0x12)) {
                 std::cerr << "[BDOS] FCB at 0x" << std::hex << val << ": drv=";
                 uint8_t b = mem_->read_bank(0, val);
                 std::cerr << (int)b << " name=";
@@ -243,17 +274,17 @@ void XIOS::handle_port_dispatch(uint8_t func) {
         // GETBUFBYTE debug trace
         case 0x80: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[GETBUFBYTE] buf_base=0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[GETBUFBYTE] buf_base=0x%lx", val);
             break;
         }
         case 0x81: {
             uint16_t val = cpu_->regs.BC.get_pair16();
-            std::cerr << "[GETBUFBYTE] final_addr=0x" << std::hex << val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[GETBUFBYTE] final_addr=0x%lx", val);
             break;
         }
         case 0x82: {
             uint8_t val = cpu_->regs.BC.get_low();
-            std::cerr << "[GETBUFBYTE] value=0x" << std::hex << (int)val << std::dec << "\n";
+            ALOG(XIOS, DEBUG, "[GETBUFBYTE] value=0x%lx", val);
             break;
         }
 
@@ -290,22 +321,22 @@ void XIOS::do_const() {
     uint8_t status = con ? con->const_status() : 0x00;
 
     // DEBUG: Track LDRBIOS polling during boot
-    if (DEBUG_BOOT) {
+    if (ALOG_ENABLED(BOOT, DEBUG)) {
         static int boot_const_count = 0;
         static bool boot_phase_complete = false;
         uint16_t pc = cpu_->regs.PC.get_pair16();
         if (pc >= 0x1700 && pc < 0x1900) {  // LDRBIOS range
             boot_const_count++;
             if (boot_const_count == 10000) {
-                std::cerr << "[DEBUG] LDRBIOS polled CONST 10000 times" << std::endl;
+                ALOG(BOOT, DEBUG, "[DEBUG] LDRBIOS polled CONST 10000 times");
             }
             if (boot_const_count == 100000) {
-                std::cerr << "[DEBUG] LDRBIOS polled CONST 100000 times - trying keypress injection" << std::endl;
+                ALOG(BOOT, DEBUG, "[DEBUG] LDRBIOS polled CONST 100000 times - trying keypress injection");
                 status = 0xFF;  // Pretend character available
             }
         } else if (!boot_phase_complete && boot_const_count > 0) {
-            std::cerr << "[DEBUG] Boot phase ended after " << boot_const_count
-                      << " LDRBIOS CONST polls, PC now at 0x" << std::hex << pc << std::dec << std::endl;
+            ALOG(BOOT, DEBUG, "[DEBUG] Boot phase ended after %lu LDRBIOS CONST polls, PC now at 0x%lx",
+                 boot_const_count, pc);
             boot_phase_complete = true;
         }
     }
@@ -342,23 +373,23 @@ void XIOS::do_conout() {
             boot_line += (char)ch;
         } else if (ch == 0x0D || ch == 0x0A) {
             if (!boot_line.empty()) {
-                if (DEBUG_BOOT) {
+                // The accumulated line is a std::string, which a ring
+                // record cannot carry - boot-only, so synchronous is fine
+                if (ALOG_ENABLED(BOOT, DEBUG)) {
                     std::cerr << "[BOOT] " << boot_line << std::endl;
                 }
                 // Check if this is the last bank message
                 if (boot_line.find("Bank 7") != std::string::npos) {
                     boot_complete = true;
                     g_boot_display_complete = true;  // Set global flag for XIOS tracing
-                    if (DEBUG_BOOT) {
-                        std::cerr << "[DEBUG] *** MPMLDR boot display complete ***" << std::endl;
-                    }
+                    ALOG(BOOT, DEBUG, "[DEBUG] *** MPMLDR boot display complete ***");
                 }
                 boot_line.clear();
             }
         }
     }
     // Post-boot console output - just log first few per console (debug only)
-    if (DEBUG_BOOT && boot_complete) {
+    if (ALOG_ENABLED(BOOT, DEBUG) && boot_complete) {
         static int conout_count[8] = {0};
         if (console < 8) {
             conout_count[console]++;
@@ -384,6 +415,32 @@ void XIOS::do_conout() {
     }
 }
 
+void XIOS::do_conouts() {
+    // String output: D = console, E = length (0 treated as 256),
+    // HL = buffer address in the current bank or common memory.
+    // Returns count actually queued in A; the caller retries the
+    // remainder after polling if the queue was full.
+    uint8_t console = cpu_->regs.DE.get_high();
+    size_t len = cpu_->regs.DE.get_low();
+    if (len == 0) len = 256;
+    uint16_t addr = cpu_->regs.HL.get_pair16();
+
+    if (console >= 8) {
+        uint16_t pc = cpu_->regs.PC.get_pair16();
+        std::cerr << "[CONOUTS] Invalid console " << (int)console
+                  << " DE=0x" << std::hex << cpu_->regs.DE.get_pair16()
+                  << " PC=0x" << pc << std::dec << "\n";
+        throw std::invalid_argument("invalid console conouts");
+    }
+
+    uint8_t buf[256];
+    mem_->copy_out(mem_->current_bank(), addr, buf, len);
+
+    Console* con = ConsoleManager::instance().get(console);
+    size_t written = con ? con->write_string(buf, len) : len;
+    cpu_->regs.AF.set_high(static_cast<uint8_t>(written));
+}
+
 // Disk I/O
 void XIOS::do_home() {
     current_track_ = 0;
@@ -409,7 +466,7 @@ void XIOS::do_settrk() {
     // Assembly copies BC to HL before OUT
     current_track_ = cpu_->regs.HL.get_pair16();
     if (current_track_ > 1000) {
-        std::cerr << "[SETTRK] T" << current_track_ << " (invalid for hd1k!)\n";
+        ALOG(DISK, ERROR, "[SETTRK] T%lu (invalid for hd1k!)", current_track_);
     }
 }
 
@@ -430,13 +487,12 @@ void XIOS::do_read() {
 
     int result = DiskSystem::instance().read(mem_);
 
-    if (DEBUG_DISK_ERRORS && result != 0) {
-        std::cerr << "[READ ERROR] T" << current_track_ << " S" << current_sector_
-                  << " DMA=" << std::hex << dma_addr_ << std::dec
-                  << " ERR=" << result << "\n";
+    if (result != 0) {
+        ALOG(DISK, ERROR, "[READ ERROR] T%lu S%lu DMA=%lx ERR=%lu",
+             current_track_, current_sector_, dma_addr_, result);
     }
 
-    if (DEBUG_DISK) {
+    if (ALOG_ENABLED(DISK, DEBUG)) {
         static int read_count = 0;
         static int high_track_count = 0;
         bool should_print = false;
@@ -449,12 +505,8 @@ void XIOS::do_read() {
         }
 
         if (should_print) {
-            std::cerr << "[READ] T" << current_track_ << " S" << current_sector_
-                      << " -> " << std::hex << dma_addr_ << std::dec;
-            if (result != 0) {
-                std::cerr << " ERR=" << result;
-            }
-            std::cerr << "\n";
+            ALOG(DISK, DEBUG, "[READ] T%lu S%lu -> %lx ERR=%lu",
+                 current_track_, current_sector_, dma_addr_, result);
             read_count++;
         }
     }
@@ -471,6 +523,38 @@ void XIOS::do_write() {
     cpu_->regs.AF.set_high(result);
 }
 
+// Multi-sector transfer - moves N consecutive 128-byte records in one
+// dispatch, avoiding a SETSEC/SETDMA/READ port round trip per record
+
+void XIOS::do_setseccnt() {
+    uint8_t count = cpu_->regs.BC.get_low();  // C = record count
+    sector_count_ = count ? count : 1;
+}
+
+void XIOS::do_readm() {
+    DiskSystem::instance().set_track(current_track_);
+    DiskSystem::instance().set_sector(current_sector_);
+    DiskSystem::instance().set_dma(dma_addr_, dma_bank_);
+
+    int result = DiskSystem::instance().read_multi(mem_, sector_count_);
+
+    if (result != 0) {
+        ALOG(DISK, ERROR, "[READM ERROR] T%lu S%lu N%lu DMA=%lx ERR=%lu",
+             current_track_, current_sector_, sector_count_, dma_addr_, result);
+    }
+
+    cpu_->regs.AF.set_high(result);
+}
+
+void XIOS::do_writem() {
+    DiskSystem::instance().set_track(current_track_);
+    DiskSystem::instance().set_sector(current_sector_);
+    DiskSystem::instance().set_dma(dma_addr_, dma_bank_);
+
+    int result = DiskSystem::instance().write_multi(mem_, sector_count_);
+    cpu_->regs.AF.set_high(result);
+}
+
 void XIOS::do_sectran() {
     // Assembly copies BC to HL before OUT, DE = translation table
     uint16_t logical = cpu_->regs.HL.get_pair16();
@@ -500,18 +584,13 @@ void XIOS::do_selmemory() {
     }
 
     // Debug: trace bank switches after SYSTEMINIT
-    if (systeminit_done_.load()) {
-        if (DEBUG_XIOS) {
-            static int selmem_count = 0;
-            selmem_count++;
-            if (selmem_count < 10) {
-                uint16_t pc = cpu_->regs.PC.get_pair16();
-                uint16_t sp = cpu_->regs.SP.get_pair16();
-                uint8_t old_bank = mem_->current_bank();
-                std::cerr << "[SELMEM] #" << selmem_count << " PC=" << std::hex << pc
-                          << " SP=" << sp << " bank " << std::dec << (int)old_bank
-                          << "->" << (int)bank << "\n";
-            }
+    if (systeminit_done_.load() && ALOG_ENABLED(XIOS, DEBUG)) {
+        static int selmem_count = 0;
+        selmem_count++;
+        if (selmem_count < 10) {
+            ALOG(XIOS, DEBUG, "[SELMEM] #%lu PC=%lx SP=%lx bank %lu->%lu",
+                 selmem_count, cpu_->regs.PC.get_pair16(),
+                 cpu_->regs.SP.get_pair16(), mem_->current_bank(), bank);
         }
     }
 
@@ -566,18 +645,14 @@ void XIOS::do_stopclock() {
 void XIOS::do_maxconsole() {
     uint8_t num_consoles = mem_->read_common(0xFF01);
     cpu_->regs.AF.set_high(num_consoles);
-    if (DEBUG_XIOS) {
-        std::cerr << "[XIOS] MAXCONSOLE returns " << (int)num_consoles
-                  << " (read from 0xFF01)\n";
-    }
+    ALOG(XIOS, DEBUG, "[XIOS] MAXCONSOLE returns %lu (read from 0xFF01)",
+         num_consoles);
 }
 
 void XIOS::do_systeminit() {
     uint16_t bnk_version = cpu_->regs.HL.get_pair16();
-    if (DEBUG_XIOS) {
-        std::cerr << "[XIOS] SYSTEMINIT BNK_VERSION=" << (int)bnk_version << "\n";
-        std::cerr << "[XIOS] SYSTEMINIT called, IFF1=" << (int)cpu_->regs.IFF1 << "\n";
-    }
+    ALOG(XIOS, DEBUG, "[XIOS] SYSTEMINIT BNK_VERSION=%lu IFF1=%lu",
+         bnk_version, cpu_->regs.IFF1);
 
     // Copy interrupt vectors from bank 0 to all other banks.
     // The Z80 assembly set up bank 0's page 0 with:
@@ -587,36 +662,32 @@ void XIOS::do_systeminit() {
     // We copy the first 64 bytes (0x00-0x3F) which covers all RST vectors.
     int num_banks = mem_->num_banks();
     for (int bank = 1; bank < num_banks; bank++) {
-        for (uint16_t addr = 0; addr < 0x40; addr++) {
-            uint8_t byte = mem_->read_bank(0, addr);
-            mem_->write_bank(bank, addr, byte);
-        }
-    }
-    if (DEBUG_XIOS) {
-        std::cerr << "[XIOS] Copied page 0 vectors to " << (num_banks - 1) << " banks\n";
+        mem_->copy_in(bank, 0, mem_->bank_data(0), 0x40);
     }
+    ALOG(XIOS, DEBUG, "[XIOS] Copied page 0 vectors to %lu banks",
+         num_banks - 1);
 
     // Enable timer interrupts
     tick_enabled_.store(true);
     systeminit_done_.store(true);
 
-    if (DEBUG_XIOS) {
+    if (ALOG_ENABLED(XIOS, DEBUG)) {
         // Debug: show return address and stack
         uint16_t sp = cpu_->regs.SP.get_pair16();
         uint8_t bank = mem_->current_bank();
         uint16_t ret_lo = mem_->read_bank(bank, sp);
         uint16_t ret_hi = mem_->read_bank(bank, sp + 1);
         uint16_t ret_addr = ret_lo | (ret_hi << 8);
-        std::cerr << "[XIOS] SYSTEMINIT returning: SP=" << std::hex << sp
-                  << " RetAddr=" << ret_addr << " Bank=" << std::dec << (int)bank << "\n";
+        ALOG(XIOS, DEBUG, "[XIOS] SYSTEMINIT returning: SP=%lx RetAddr=%lx Bank=%lu",
+             sp, ret_addr, bank);
 
         // Debug: show RST 1 vector (at address 0x0008) in bank 0
         uint8_t rst1_opcode = mem_->read_bank(0, 0x0008);
         uint8_t rst1_lo = mem_->read_bank(0, 0x0009);
         uint8_t rst1_hi = mem_->read_bank(0, 0x000A);
         uint16_t rst1_target = rst1_lo | (rst1_hi << 8);
-        std::cerr << "[XIOS] Bank 0 RST 1 vector: " << std::hex
-                  << (int)rst1_opcode << " " << rst1_target << std::dec << "\n";
+        ALOG(XIOS, DEBUG, "[XIOS] Bank 0 RST 1 vector: %lx %lx",
+             rst1_opcode, rst1_target);
     }
 }
 
@@ -662,8 +733,9 @@ void XIOS::do_sftp_get() {
         return;
     }
 
-    // Debug: show request being sent
-    if (DEBUG_XIOS) {
+    // Debug: show request being sent (multi-byte dump stays
+    // synchronous; a ring record cannot carry the buffer)
+    if (ALOG_ENABLED(XIOS, DEBUG)) {
         std::cerr << "[XIOS] sftp_get: buf_addr=0x" << std::hex << buf_addr << std::dec
                   << " type=" << (int)buf[0]
                   << " drive=" << (int)buf[1]
@@ -679,12 +751,10 @@ void XIOS::do_sftp_get() {
     }
 
     // Write to Z80 bank 0 memory
-    for (size_t i = 0; i < SFTP_BUF_SIZE; i++) {
-        mem_->write_bank(0, buf_addr + i, buf[i]);
-    }
+    mem_->copy_in(0, buf_addr, buf, SFTP_BUF_SIZE);
 
     // Verify data was written correctly (debug only)
-    if (DEBUG_XIOS) {
+    if (ALOG_ENABLED(XIOS, DEBUG)) {
         std::cerr << "[XIOS] verify: ";
         for (int i = 4; i < 15; i++) {
             uint8_t read_back = mem_->read_bank(0, buf_addr + i);
@@ -703,16 +773,10 @@ void XIOS::do_sftp_put() {
 
     // Read from bank 0 memory
     uint8_t buf[SFTP_BUF_SIZE];
-    for (size_t i = 0; i < SFTP_BUF_SIZE; i++) {
-        buf[i] = mem_->read_bank(0, buf_addr + i);
-    }
+    mem_->copy_out(0, buf_addr, buf, SFTP_BUF_SIZE);
 
-    if (DEBUG_XIOS) {
-        std::cerr << "[XIOS] sftp_put: buf_addr=0x" << std::hex << buf_addr
-                  << " raw[0..5]=" << std::dec << (int)buf[0] << "," << (int)buf[1]
-                  << "," << (int)buf[2] << "," << (int)buf[3]
-                  << "," << (int)buf[4] << "," << (int)buf[5] << "\n";
-    }
+    ALOG(XIOS, DEBUG, "[XIOS] sftp_put: buf_addr=0x%lx raw[0..3]=%lu,%lu,%lu,%lu",
+         buf_addr, buf[0], buf[1], buf[2], buf[3]);
 
     SftpBridge::instance().set_reply(buf, sizeof(buf));
     cpu_->regs.AF.set_high(0x00);  // Success
@@ -727,21 +791,21 @@ void XIOS::do_sftp_hello() {
 
 void XIOS::do_sftp_entry() {
     // BRS entry point reached (debug)
-    if (DEBUG_XIOS) std::cerr << "[XIOS] SFTP BRS entry point reached\n";
+    ALOG(XIOS, DEBUG, "[XIOS] SFTP BRS entry point reached");
     cpu_->regs.AF.set_high(0x00);
 }
 
 void XIOS::do_sftp_jmpaddr() {
     // Debug: report computed jump address (BC = address)
     uint16_t addr = cpu_->regs.BC.get_pair16();
-    if (DEBUG_XIOS) std::cerr << "[XIOS] SFTP computed jump addr: 0x" << std::hex << addr << std::dec << "\n";
+    ALOG(XIOS, DEBUG, "[XIOS] SFTP computed jump addr: 0x%lx", addr);
     cpu_->regs.AF.set_high(0x00);
 }
 
 void XIOS::do_sftp_epval() {
     // Debug: report ENTRY_POINT value (BC = address)
     uint16_t addr = cpu_->regs.BC.get_pair16();
-    if (DEBUG_XIOS) std::cerr << "[XIOS] SFTP ENTRY_POINT value: 0x" << std::hex << addr << std::dec << "\n";
+    ALOG(XIOS, DEBUG, "[XIOS] SFTP ENTRY_POINT value: 0x%lx", addr);
     cpu_->regs.AF.set_high(0x00);
 }
 
@@ -749,7 +813,7 @@ void XIOS::do_sftp_debug() {
     // Generic debug trace: C = trace code (identifies location in RSP)
     uint8_t code = cpu_->regs.BC.get_low();
     uint16_t pc = cpu_->regs.PC.get_pair16();
-    if (DEBUG_XIOS) std::cerr << "[RSP] Trace #" << (int)code << " at PC=0x" << std::hex << pc << std::dec << "\n";
+    ALOG(XIOS, DEBUG, "[RSP] Trace #%lu at PC=0x%lx", code, pc);
     cpu_->regs.AF.set_high(0x00);
 }
 
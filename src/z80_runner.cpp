@@ -6,13 +6,18 @@
 #include "mpm_cpu.h"
 #include "banked_mem.h"
 #include "xios.h"
+#include "block_cache.h"
 #include "console.h"
 #include "disk.h"
+#include "replay.h"
+#include "sftp_bridge.h"
+#include "stats.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 
 Z80Runner::Z80Runner()
     : running_(false)
@@ -28,8 +33,7 @@ Z80Runner::~Z80Runner() {
 bool Z80Runner::boot_from_disk() {
     // Boot the system by loading boot tracks into memory
 
-    // Create memory (8 banks for MP/M II)
-    memory_ = std::make_unique<BankedMemory>(8);
+    memory_ = std::make_unique<BankedMemory>(num_banks_);
 
     // Create CPU with memory
     cpu_ = std::make_unique<MpmCpu>(memory_.get());
@@ -77,9 +81,7 @@ bool Z80Runner::boot_from_disk() {
 
         // Load into bank 0
         uint16_t addr = i * sector_size;
-        for (size_t j = 0; j < sector_size; j++) {
-            memory_->write_bank(0, addr + j, sector_buf[j]);
-        }
+        memory_->copy_in(0, addr, sector_buf, sector_size);
     }
 
     std::cout << "Loaded " << (sectors_to_read * sector_size) << " bytes from system tracks\n";
@@ -103,10 +105,403 @@ bool Z80Runner::boot_from_disk() {
     return true;
 }
 
+// Read one 128-byte CP/M record, addressed by logical record number from
+// the start of the directory/data area (track dpb.off). Same addressing
+// math as DiskSystem::read_record; boot disks have no sector skew, so no
+// translate table applies here
+static bool read_cpm_record(Disk* disk, uint32_t record, uint8_t* out) {
+    const DiskParameterBlock& dpb = disk->dpb();
+    uint16_t track = dpb.off + record / dpb.spt;
+    uint16_t logical = record % dpb.spt;
+    uint16_t records_per_phys = disk->sector_size() / 128;
+    uint16_t phys_sector = logical / records_per_phys;
+    uint16_t offset = (logical % records_per_phys) * 128;
+
+    const uint8_t* src = disk->sector_ptr(track, phys_sector);
+    uint8_t buf[512];
+    if (!src) {
+        disk->set_track(track);
+        disk->set_sector(phys_sector);
+        if (disk->read_sector(buf) != 0) return false;
+        src = buf;
+    }
+    std::memcpy(out, src + offset, 128);
+    return true;
+}
+
+bool Z80Runner::fast_boot() {
+    // Same component wiring as boot_from_disk()
+    memory_ = std::make_unique<BankedMemory>(num_banks_);
+    cpu_ = std::make_unique<MpmCpu>(memory_.get());
+    cpu_->set_cpu_mode(qkz80::MODE_Z80);
+    xios_ = std::make_unique<XIOS>(cpu_.get(), memory_.get());
+    cpu_->set_xios(xios_.get());
+    cpu_->set_banked_mem(memory_.get());
+
+    Disk* disk = DiskSystem::instance().get(0);
+    if (!disk || !disk->is_open()) {
+        std::cerr << "Cannot boot: no disk mounted on drive A:\n";
+        return false;
+    }
+
+    std::cout << "Fast boot from disk A...\n";
+
+    // Scan the directory for MPM.SYS (user 0; attribute bits masked).
+    // Each 32-byte entry covers exm+1 logical extents and holds 16 block
+    // numbers (8 16-bit ones when the disk has more than 255 blocks), so
+    // the blocks of entry n start at file-block slot n * slots
+    const DiskParameterBlock& dpb = disk->dpb();
+    static const char MPM_SYS[11] = {'M', 'P', 'M', ' ', ' ', ' ', ' ', ' ',
+                                     'S', 'Y', 'S'};
+    const bool word_blocks = dpb.dsm > 255;
+    const size_t slots = word_blocks ? 8 : 16;
+    const uint32_t dir_records = (dpb.drm + 1) / 4;
+    std::vector<uint32_t> file_blocks;  // 0 = unallocated (block 0 is directory)
+
+    uint8_t rec[128];
+    for (uint32_t r = 0; r < dir_records; r++) {
+        if (!read_cpm_record(disk, r, rec)) {
+            std::cerr << "Failed to read directory record " << r << "\n";
+                return false;
+        }
+        for (int e = 0; e < 4; e++) {
+            const uint8_t* ent = rec + e * 32;
+            if (ent[0] != 0) continue;  // user 0 only; 0xE5 = erased
+            bool match = true;
+            for (int i = 0; i < 11; i++) {
+                if ((ent[1 + i] & 0x7F) != MPM_SYS[i]) { match = false; break; }
+            }
+            if (!match) continue;
+            uint32_t extent = (ent[12] | (ent[14] << 5)) / (dpb.exm + 1);
+            size_t base = extent * slots;
+            if (file_blocks.size() < base + slots) {
+                file_blocks.resize(base + slots, 0);
+            }
+            for (size_t i = 0; i < slots; i++) {
+                file_blocks[base + i] = word_blocks
+                    ? static_cast<uint32_t>(ent[16 + i * 2] | (ent[17 + i * 2] << 8))
+                    : ent[16 + i];
+            }
+        }
+    }
+
+    if (file_blocks.empty() || file_blocks[0] == 0) {
+        std::cerr << "MPM.SYS not found on drive A:\n";
+        return false;
+    }
+
+    const uint32_t records_per_block = 1u << dpb.bsh;
+    auto read_file_record = [&](uint32_t frec, uint8_t* out) -> bool {
+        uint32_t bi = frec / records_per_block;
+        if (bi >= file_blocks.size() || file_blocks[bi] == 0) return false;
+        uint32_t abs = file_blocks[bi] * records_per_block
+                     + frec % records_per_block;
+        return read_cpm_record(disk, abs, out);
+    };
+
+    // Records 0-1 are SYSTEM.DAT; it describes the rest of the image
+    uint8_t sysdat[256];
+    if (!read_file_record(0, sysdat) || !read_file_record(1, sysdat + 128)) {
+        std::cerr << "Failed to read SYSTEM.DAT from MPM.SYS\n";
+        return false;
+    }
+
+    const uint32_t mem_top = sysdat[0];           // top page of the OS image
+    const uint32_t entry = sysdat[11] << 8;       // XDOS cold entry page
+    const uint32_t nmb_records = sysdat[120] | (sysdat[121] << 8);
+    if (mem_top == 0 || entry == 0 || nmb_records <= 2 ||
+        (nmb_records - 2) * 128u > mem_top * 256u) {
+        std::cerr << "MPM.SYS has implausible SYSTEM.DAT (mem top 0x"
+                  << std::hex << mem_top << ", entry 0x" << entry
+                  << std::dec << ", " << nmb_records << " records)\n";
+        return false;
+    }
+
+    // Place the image exactly as MPMLDR does: SYSTEM.DAT at mem_top*256
+    // and the remaining records downward from there (GENSYS stores them
+    // high-address-first), then transfer to the XDOS cold entry
+    memory_->copy_in(0, mem_top * 256, sysdat, 256);
+    for (uint32_t k = 2; k < nmb_records; k++) {
+        if (!read_file_record(k, rec)) {
+            std::cerr << "Failed to read MPM.SYS record " << k << "\n";
+                return false;
+        }
+        memory_->copy_in(0, mem_top * 256 - (k - 1) * 128, rec, 128);
+    }
+
+    std::cout << "Loaded MPM.SYS (" << nmb_records << " records, top page 0x"
+              << std::hex << mem_top << std::dec << ")\n";
+
+    cpu_->regs.PC.set_pair16(entry);
+    // MPMLDR transfers with its stack in the TPA; XDOS switches stacks
+    // during initialization, so the value only needs to be harmless
+    cpu_->regs.SP.set_pair16(0x0BA4);
+
+    std::cout << "Starting execution at 0x" << std::hex << std::setw(4)
+              << std::setfill('0') << entry << std::dec << "\n\n";
+
+    return true;
+}
+
+// Snapshot file layout, version 1 (all integers little-endian):
+//   8 bytes   magic "MPM2SNAP"
+//   u32       version
+//   u16 x 6   AF, BC, DE, HL, PC, SP
+//   u8        IFF1
+//   u64       cycle counter
+//   u8        number of banks
+//   u8        current bank
+//   XIOS state (base, disk, track, sector, DMA addr/bank, record count,
+//   clock and SYSTEMINIT flags)
+//   raw RAM: num_banks x 48KB bank images, then the 16KB common area
+// Fields are written individually rather than as structs so the format
+// does not depend on host padding or endianness.
+static const char SNAP_MAGIC[8] = {'M', 'P', 'M', '2', 'S', 'N', 'A', 'P'};
+static constexpr uint32_t SNAP_VERSION = 1;
+
+static void put_u8(std::ofstream& f, uint8_t v) {
+    f.write(reinterpret_cast<const char*>(&v), 1);
+}
+
+static void put_u16(std::ofstream& f, uint16_t v) {
+    uint8_t b[2] = {static_cast<uint8_t>(v & 0xFF),
+                    static_cast<uint8_t>(v >> 8)};
+    f.write(reinterpret_cast<const char*>(b), 2);
+}
+
+static void put_u32(std::ofstream& f, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        put_u8(f, static_cast<uint8_t>(v >> (i * 8)));
+    }
+}
+
+static void put_u64(std::ofstream& f, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        put_u8(f, static_cast<uint8_t>(v >> (i * 8)));
+    }
+}
+
+static uint8_t get_u8(std::ifstream& f) {
+    uint8_t v = 0;
+    f.read(reinterpret_cast<char*>(&v), 1);
+    return v;
+}
+
+static uint16_t get_u16(std::ifstream& f) {
+    uint16_t lo = get_u8(f);
+    uint16_t hi = get_u8(f);
+    return static_cast<uint16_t>(lo | (hi << 8));
+}
+
+static uint32_t get_u32(std::ifstream& f) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        v |= static_cast<uint32_t>(get_u8(f)) << (i * 8);
+    }
+    return v;
+}
+
+static uint64_t get_u64(std::ifstream& f) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v |= static_cast<uint64_t>(get_u8(f)) << (i * 8);
+    }
+    return v;
+}
+
+bool Z80Runner::save_snapshot(const std::string& path) const {
+    if (!cpu_ || !memory_ || !xios_) return false;
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) {
+        std::cerr << "Cannot create snapshot file: " << path << "\n";
+        return false;
+    }
+
+    f.write(SNAP_MAGIC, sizeof(SNAP_MAGIC));
+    put_u32(f, SNAP_VERSION);
+
+    put_u16(f, cpu_->regs.AF.get_pair16());
+    put_u16(f, cpu_->regs.BC.get_pair16());
+    put_u16(f, cpu_->regs.DE.get_pair16());
+    put_u16(f, cpu_->regs.HL.get_pair16());
+    put_u16(f, cpu_->regs.PC.get_pair16());
+    put_u16(f, cpu_->regs.SP.get_pair16());
+    put_u8(f, cpu_->regs.IFF1 ? 1 : 0);
+    put_u64(f, cpu_->cycles);
+
+    put_u8(f, static_cast<uint8_t>(memory_->num_banks()));
+    put_u8(f, memory_->current_bank());
+
+    XIOS::State xs = xios_->get_state();
+    put_u16(f, xs.xios_base);
+    put_u8(f, xs.current_disk);
+    put_u16(f, xs.current_track);
+    put_u16(f, xs.current_sector);
+    put_u16(f, xs.dma_addr);
+    put_u8(f, xs.dma_bank);
+    put_u8(f, xs.sector_count);
+    put_u8(f, xs.tick_enabled);
+    put_u8(f, xs.systeminit_done);
+
+    for (int bank = 0; bank < memory_->num_banks(); bank++) {
+        f.write(reinterpret_cast<const char*>(memory_->bank_data(bank)),
+                BankedMemory::BANK_SIZE);
+    }
+    f.write(reinterpret_cast<const char*>(memory_->common_data()),
+            BankedMemory::COMMON_SIZE);
+
+    return f.good();
+}
+
+bool Z80Runner::load_snapshot(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "Cannot open snapshot file: " << path << "\n";
+        return false;
+    }
+
+    char magic[8];
+    f.read(magic, sizeof(magic));
+    if (!f || std::memcmp(magic, SNAP_MAGIC, sizeof(SNAP_MAGIC)) != 0) {
+        std::cerr << "Not a snapshot file: " << path << "\n";
+        return false;
+    }
+    uint32_t version = get_u32(f);
+    if (version != SNAP_VERSION) {
+        std::cerr << "Unsupported snapshot version " << version
+                  << " in " << path << "\n";
+        return false;
+    }
+
+    uint16_t af = get_u16(f);
+    uint16_t bc = get_u16(f);
+    uint16_t de = get_u16(f);
+    uint16_t hl = get_u16(f);
+    uint16_t pc = get_u16(f);
+    uint16_t sp = get_u16(f);
+    uint8_t iff1 = get_u8(f);
+    uint64_t cycles = get_u64(f);
+
+    int num_banks = get_u8(f);
+    uint8_t current_bank = get_u8(f);
+    if (num_banks < 1 || num_banks > 32 || current_bank >= num_banks) {
+        std::cerr << "Corrupt snapshot (banks=" << num_banks
+                  << " current=" << (int)current_bank << ")\n";
+        return false;
+    }
+
+    XIOS::State xs;
+    xs.xios_base = get_u16(f);
+    xs.current_disk = get_u8(f);
+    xs.current_track = get_u16(f);
+    xs.current_sector = get_u16(f);
+    xs.dma_addr = get_u16(f);
+    xs.dma_bank = get_u8(f);
+    xs.sector_count = get_u8(f);
+    xs.tick_enabled = get_u8(f);
+    xs.systeminit_done = get_u8(f);
+
+    // Same component wiring as boot_from_disk(), minus the boot-track load
+    memory_ = std::make_unique<BankedMemory>(num_banks);
+    cpu_ = std::make_unique<MpmCpu>(memory_.get());
+    cpu_->set_cpu_mode(qkz80::MODE_Z80);
+    xios_ = std::make_unique<XIOS>(cpu_.get(), memory_.get());
+    cpu_->set_xios(xios_.get());
+    cpu_->set_banked_mem(memory_.get());
+
+    for (int bank = 0; bank < num_banks; bank++) {
+        f.read(reinterpret_cast<char*>(memory_->bank_data(bank)),
+               BankedMemory::BANK_SIZE);
+    }
+    f.read(reinterpret_cast<char*>(memory_->common_data()),
+           BankedMemory::COMMON_SIZE);
+    if (!f) {
+        std::cerr << "Truncated snapshot file: " << path << "\n";
+        return false;
+    }
+
+    memory_->select_bank(current_bank);
+    xios_->set_state(xs);
+
+    cpu_->regs.AF.set_pair16(af);
+    cpu_->regs.BC.set_pair16(bc);
+    cpu_->regs.DE.set_pair16(de);
+    cpu_->regs.HL.set_pair16(hl);
+    cpu_->regs.PC.set_pair16(pc);
+    cpu_->regs.SP.set_pair16(sp);
+    cpu_->regs.IFF1 = iff1;
+    cpu_->cycles = cycles;
+
+    std::cout << "Restored snapshot " << path << " ("
+              << num_banks << " banks, PC=0x" << std::hex << pc
+              << std::dec << ")\n";
+
+    return true;
+}
+
 uint64_t Z80Runner::cycles() const {
     return cpu_ ? cpu_->cycles : 0;
 }
 
+bool Z80Runner::is_idle() const {
+    return cpu_ && cpu_->is_halted();
+}
+
+void Z80Runner::deliver_tick() {
+    // Use RST 1 for timer, leaving RST 7 free for DDT debugger
+    const int RST_INTERRUPT(1);
+
+    Replay::instance().record_tick();
+
+    // Auto-start clock after boot completes (5M instructions)
+    if (!clock_auto_started_ && instruction_count_.load() > 5000000) {
+        xios_->start_clock();
+        clock_auto_started_ = true;
+    }
+
+    // Request tick interrupt if clock is enabled
+    if (xios_->clock_enabled()) {
+        // Always request the interrupt - CPU will process when IFF1 becomes 1
+        cpu_->request_rst(RST_INTERRUPT);  // RST 38H
+    }
+}
+
+void Z80Runner::set_profile_rate(int hz) {
+    profile_hz_ = hz;
+    if (hz > 0) {
+        profile_interval_ = std::chrono::microseconds(1000000 / hz);
+        next_sample_ = std::chrono::steady_clock::now() + profile_interval_;
+    }
+}
+
+void Z80Runner::enable_block_cache() {
+    if (!cpu_ || !memory_) return;
+
+    if (!block_cache_) {
+        block_cache_ = std::make_unique<BlockCache>();
+    }
+    block_cache_->set_enabled(true);
+    cpu_->set_block_cache(block_cache_.get());
+    memory_->set_block_cache(block_cache_.get());
+}
+
+// True when a session is waiting on the guest: console bytes queued in
+// either direction, or a bridge request parked for the SFTP RSP. All
+// checks are relaxed/acquire atomic loads except the bridge one, which
+// takes its (uncontended) queue mutex - cheap at once per batch
+static bool interactive_io_pending() {
+    ConsoleManager& cm = ConsoleManager::instance();
+    for (int i = 0; i < cm.max_console(); i++) {
+        Console* con = cm.get(i);
+        if (con && con->is_connected() &&
+            (con->input_queue().ready() || con->output_queue().ready())) {
+            return true;
+        }
+    }
+    return SftpBridge::instance().has_pending_request();
+}
+
 bool Z80Runner::run_polled() {
     // Single-threaded polling mode - runs a batch of instructions
     // Returns false when should exit (shutdown or timeout)
@@ -114,59 +509,148 @@ bool Z80Runner::run_polled() {
     if (stop_requested_.load()) return false;
 
     // Initialize timing on first call
-    static bool first_call = true;
-    if (first_call) {
+    if (!started_) {
         start_time_ = std::chrono::steady_clock::now();
         next_tick_ = start_time_;
+        load_window_start_ = start_time_;
         instruction_count_.store(0);
         running_.store(true);
-        first_call = false;
+        started_ = true;
     }
 
-    // Run a batch of instructions
-    for (int batch = 0; batch < 10000; batch++) {
-        // Check for timeout
-        auto now = std::chrono::steady_clock::now();
-        if (timeout_seconds_ > 0) {
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time_).count();
-            if (elapsed >= timeout_seconds_) {
-                timed_out_.store(true);
-                return false;
-            }
+    // Timeout and tick checks happen once per batch, not per instruction
+    auto now = std::chrono::steady_clock::now();
+    if (timeout_seconds_ > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time_).count();
+        if (elapsed >= timeout_seconds_) {
+            timed_out_.store(true);
+            return false;
         }
+    }
 
-	// Use RST 1 for timer, leaving RST 7 free for DDT debugger
-	const int RST_INTERRUPT(1);
-        // Check for timer interrupt (60Hz tick)
-        if (now >= next_tick_) {
+    // Check for timer interrupt (60Hz tick)
+    // Turbo mode: tick is driven by emulated cycles, not wall clock, so
+    // the guest sees a consistent tick rate however fast the host runs
+    if (Replay::instance().replaying()) {
+        // Trace-driven: ticks and session input are re-injected at
+        // their recorded instruction counts. Keep the turbo virtual
+        // tick resynced so generated ticks resume seamlessly when the
+        // trace runs out
+        int ticks = Replay::instance().inject_due(instruction_count_.load(),
+                                                  cpu_->is_halted());
+        while (ticks-- > 0) {
+            deliver_tick();
+        }
+        next_tick_cycles_ = cpu_->cycles + TURBO_CYCLES_PER_TICK;
+    } else if (turbo_) {
+        // A halted CPU accrues no cycles, so skip straight to the next
+        // virtual tick instead of waiting forever
+        if (cpu_->cycles >= next_tick_cycles_ || cpu_->is_halted()) {
+            next_tick_cycles_ = cpu_->cycles + TURBO_CYCLES_PER_TICK;
+            deliver_tick();
+        }
+    } else if (now >= next_tick_) {
+        // Advance by the fixed period rather than from `now`, so batch
+        // overshoot doesn't accumulate into the tick cadence - MP/M II
+        // slices process time by counting ticks, and a drifting period
+        // shortchanges whoever is running. After a long stall (disk
+        // flush, host scheduling) resynchronize instead of delivering a
+        // burst of catch-up ticks the dispatcher would mistake for
+        // elapsed time slices.
+        next_tick_ += TICK_INTERVAL;
+        if (now - next_tick_ > 4 * TICK_INTERVAL) {
             next_tick_ = now + TICK_INTERVAL;
+        }
+        deliver_tick();
+    }
 
-            // Auto-start clock after boot completes (5M instructions)
-            static bool auto_started = false;
-            if (!auto_started && instruction_count_.load() > 5000000) {
-                xios_->start_clock();
-                auto_started = true;
-            }
+    // Take a PC sample when the profiler interval has elapsed. One
+    // sample per batch; the batch cap below keeps batches short enough
+    // to hit the requested rate
+    if (profile_hz_ > 0 && now >= next_sample_) {
+        next_sample_ = now + profile_interval_;
+        Stats::instance().count_pc_sample(memory_->current_bank(),
+                                          cpu_->regs.PC.get_pair16());
+    }
 
-            // Request tick interrupt if clock is enabled
-            if (xios_->clock_enabled()) {
-                // Always request the interrupt - CPU will process when IFF1 becomes 1
-                cpu_->request_rst(RST_INTERRUPT);  // RST 38H
-            }
+    // Close the guest-load reporting window about once a second: MIPS
+    // over the window, fraction of poll rounds that found the CPU
+    // halted, and the batch size in use - exported under /stats "load"
+    polls_++;
+    if (now - load_window_start_ >= std::chrono::seconds(1)) {
+        uint64_t instr = instruction_count_.load();
+        double secs = std::chrono::duration<double>(now - load_window_start_).count();
+        Stats::instance().set_runner_load(
+            (instr - load_window_instr_) / secs / 1e6,
+            polls_ > 0 ? static_cast<double>(polls_halted_) / polls_ : 0.0,
+            last_batch_);
+        load_window_start_ = now;
+        load_window_instr_ = instr;
+        polls_ = 0;
+        polls_halted_ = 0;
+    }
+
+    if (cpu_->check_interrupts()) {
+        cpu_->clear_halted();
+    }
+
+    // When halted, return to caller to allow SSH/console polling
+    if (cpu_->is_halted()) {
+        polls_halted_++;
+        return true;
+    }
+
+    // Size the batch from the time remaining to the next tick using a
+    // running instructions-per-second estimate, so we neither overshoot
+    // the tick deadline nor pay a clock read per instruction.
+    // Turbo has no wall-clock deadline - use a fixed batch so the cycle
+    // count is checked often enough for tick regularity.
+    int batch;
+    if (turbo_) {
+        batch = TURBO_BATCH;
+    } else {
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(next_tick_ - now);
+        int64_t budget = static_cast<int64_t>(ips_estimate_ * remaining.count() / 1e6);
+        // Profiling above the tick rate needs batches shorter than a
+        // tick interval, since samples are taken between batches
+        if (profile_hz_ > 0) {
+            int64_t sample_budget = static_cast<int64_t>(ips_estimate_ / profile_hz_);
+            budget = std::min(budget, sample_budget);
         }
+        batch = static_cast<int>(std::min<int64_t>(std::max<int64_t>(budget, MIN_BATCH), MAX_BATCH));
+    }
 
-	if (cpu_->check_interrupts()) {
-	  cpu_->clear_halted();
-	}
+    // With a session waiting on the guest, cap the batch at roughly a
+    // millisecond of instructions so control returns to the console/SSH
+    // polling loop quickly; compute-bound stretches keep the full
+    // tick/turbo budget above. One size cannot serve both an operator
+    // typing at the TMP and a batch compile.
+    if (interactive_io_pending()) {
+        int cap = std::max(static_cast<int>(ips_estimate_ / 1000), MIN_BATCH);
+        batch = std::min(batch, cap);
+    }
 
-	// When halted, break out of batch loop to allow SSH/console polling
-	if (cpu_->is_halted()) {
-	  break;
-	}
+    // Replay: clip the batch at the next trace event's timestamp so it
+    // is injected at the recorded instruction count, not up to a batch
+    // late
+    if (Replay::instance().replaying()) {
+        uint64_t cur = instruction_count_.load();
+        uint64_t next = Replay::instance().next_event_instr();
+        if (next > cur && next - cur < static_cast<uint64_t>(batch)) {
+            batch = static_cast<int>(next - cur);
+        }
+    }
+    last_batch_ = batch;
 
-        cpu_->execute();
-        instruction_count_++;
+    int executed = cpu_->execute_batch(batch);
+    instruction_count_ += executed;
 
+    // Update the IPS estimate (EWMA) from what the batch actually took
+    auto after = std::chrono::steady_clock::now();
+    auto batch_us = std::chrono::duration_cast<std::chrono::microseconds>(after - now).count();
+    if (batch_us > 0 && executed > 0) {
+        double measured = executed * 1e6 / batch_us;
+        ips_estimate_ = ips_estimate_ * 0.9 + measured * 0.1;
     }
 
     return true;
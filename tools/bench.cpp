@@ -0,0 +1,295 @@
+// bench.cpp - Benchmark suite for the MP/M II emulator
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Measures the emulator's hot paths in isolation and emits one JSON
+// object on stdout so CI can track regressions across releases:
+//   interp_mips         raw interpreter speed on a CPU-bound guest loop
+//   cycles_per_instr    emulated cycles per instruction on that loop
+//   disk_iops           128-byte record reads/sec through DiskSystem
+//   bridge_rtt_us       SFTP bridge enqueue/dequeue/reply round trip
+//                       (C++ queue machinery only, no Z80 in the loop)
+//   bridge_stream_mbps  streamed reply throughput through the bridge
+//   console_mbps        console output queue throughput
+//   boot_to_prompt_ms   wall time from cold boot to first TMP prompt
+//                       (null unless a system image is given with -d)
+//
+// Usage: mpm2_bench [-d disks/mpm2_system.img]
+//
+// Build and run via the `bench` target: cmake --build build -t bench
+
+#include "banked_mem.h"
+#include "mpm_cpu.h"
+#include "console.h"
+#include "disk.h"
+#include "sftp_bridge.h"
+#include "z80_runner.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Raw interpreter speed: a 16-bit counter loop (INC/LD/OR/JP) poked
+// into bank 0, run in execute_batch slices for ~1 second
+static void bench_interpreter(double& mips, double& cpi) {
+    BankedMemory mem(2);
+    MpmCpu cpu(&mem);
+    cpu.set_cpu_mode(qkz80::MODE_Z80);
+    cpu.set_banked_mem(&mem);
+
+    static const uint8_t loop_code[] = {
+        0x21, 0x00, 0x00,   // 0100: LD HL,0
+        0x23,               // 0103: INC HL
+        0x7C,               // 0104: LD A,H
+        0xB5,               // 0105: OR L
+        0xC3, 0x03, 0x01,   // 0106: JP 0103
+    };
+    mem.load(0, 0x0100, loop_code, sizeof(loop_code));
+    cpu.regs.PC.set_pair16(0x0100);
+    cpu.regs.SP.set_pair16(0xFF00);
+
+    uint64_t executed = 0;
+    auto start = Clock::now();
+    double elapsed;
+    do {
+        executed += cpu.execute_batch(100000);
+        elapsed = seconds_since(start);
+    } while (elapsed < 1.0);
+
+    mips = executed / elapsed / 1e6;
+    cpi = executed ? static_cast<double>(cpu.cycles) / executed : 0.0;
+}
+
+// Disk record throughput: sequential 128-byte reads through the same
+// DiskSystem::read() path XIOS READ uses, against a scratch image
+static double bench_disk_iops() {
+    char path[] = "/tmp/mpm2_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return 0.0;
+    // 8" SSSD-sized scratch image (250KB), arbitrary contents
+    std::vector<uint8_t> fill(256256, 0xE5);
+    if (write(fd, fill.data(), fill.size()) != (ssize_t)fill.size()) {
+        ::close(fd);
+        unlink(path);
+        return 0.0;
+    }
+    ::close(fd);
+
+    double iops = 0.0;
+    if (DiskSystem::instance().mount(15, path)) {
+        BankedMemory mem(1);
+        DiskSystem::instance().select(15);
+        DiskSystem::instance().set_dma(0x0080, 0);
+
+        Disk* disk = DiskSystem::instance().get(15);
+        uint16_t spt = disk->dpb().spt;
+        uint16_t tracks = disk->tracks();
+
+        uint64_t ops = 0;
+        uint16_t track = 0, sector = 0;
+        auto start = Clock::now();
+        double elapsed;
+        do {
+            DiskSystem::instance().set_track(track);
+            DiskSystem::instance().set_sector(sector);
+            if (DiskSystem::instance().read(&mem) != 0) break;
+            if (++sector >= spt) {
+                sector = 0;
+                if (++track >= tracks) track = 0;
+            }
+            ops++;
+            elapsed = seconds_since(start);
+        } while (elapsed < 0.5);
+
+        iops = ops / elapsed;
+        DiskSystem::instance().unmount(15);
+    }
+    unlink(path);
+    return iops;
+}
+
+// Bridge round trip: enqueue a TEST request, play the Z80 side
+// (get_request + set_reply) and collect the reply - the full C++
+// queue/wakeup machinery minus the guest itself
+static double bench_bridge_rtt() {
+    auto& bridge = SftpBridge::instance();
+    uint32_t origin = bridge.allocate_origin();
+    uint8_t buf[SFTP_BUF_SIZE];
+    uint8_t reply_buf[SFTP_BUF_SIZE] = {0};
+    reply_buf[SFTP_REPLY_LENGTH_OFS] = 2;
+
+    const int N = 20000;
+    auto start = Clock::now();
+    for (int i = 0; i < N; i++) {
+        SftpRequest req;
+        req.type = SftpRequestType::TEST;
+        req.origin = origin;
+        req.drive = 0;
+        req.user = 0;
+        req.flags = 0;
+        req.offset = 0;
+        req.length = 0;
+        uint32_t id = bridge.enqueue_request(std::move(req));
+
+        if (!bridge.get_request(buf, sizeof(buf))) return 0.0;
+        bridge.set_reply(reply_buf, SFTP_REPLY_DATA_OFS + 2);
+        if (!bridge.try_get_reply(id)) return 0.0;
+    }
+    return seconds_since(start) / N * 1e6;
+}
+
+// Streamed reply throughput: one STREAM FILE_READ request, replies
+// pumped through in RSP-sized chunks (15 x 128 bytes) and drained
+static double bench_bridge_stream() {
+    auto& bridge = SftpBridge::instance();
+    uint32_t origin = bridge.allocate_origin();
+    uint8_t buf[SFTP_BUF_SIZE];
+
+    constexpr size_t CHUNK = 1920;
+    constexpr size_t TOTAL = 64 * 1024 * 1024;
+    uint8_t reply_buf[SFTP_BUF_SIZE];
+    std::memset(reply_buf, 0xAA, sizeof(reply_buf));
+    reply_buf[SFTP_REPLY_LENGTH_OFS] = CHUNK & 0xFF;
+    reply_buf[SFTP_REPLY_LENGTH_OFS + 1] = CHUNK >> 8;
+
+    SftpRequest req;
+    req.type = SftpRequestType::FILE_READ;
+    req.origin = origin;
+    req.drive = 0;
+    req.user = 0;
+    req.flags = SFTP_FLAG_STREAM;
+    req.filename = "BENCH.DAT";
+    req.offset = 0;
+    req.length = CHUNK;
+    uint32_t id = bridge.enqueue_request(std::move(req));
+    if (!bridge.get_request(buf, sizeof(buf))) return 0.0;
+
+    auto start = Clock::now();
+    size_t sent = 0;
+    while (sent < TOTAL) {
+        bool last = (sent + CHUNK >= TOTAL);
+        reply_buf[SFTP_REPLY_STATUS_OFS] =
+            last ? 0 : static_cast<uint8_t>(SftpReplyStatus::MORE_DATA);
+        bridge.set_reply(reply_buf, SFTP_REPLY_DATA_OFS + CHUNK);
+        if (!bridge.try_get_reply(id)) return 0.0;
+        sent += CHUNK;
+    }
+    return TOTAL / seconds_since(start) / 1e6;
+}
+
+// Console output bandwidth: producer/consumer through one output queue
+// in XIOS CONOUTS-sized runs
+static double bench_console() {
+    ConsoleQueue<256> queue;
+    uint8_t out[128];
+    uint8_t in[256];
+    std::memset(out, 'A', sizeof(out));
+
+    uint64_t moved = 0;
+    auto start = Clock::now();
+    double elapsed;
+    do {
+        moved += queue.write_some(out, sizeof(out));
+        moved += queue.read_some(in, sizeof(in));
+        elapsed = seconds_since(start);
+    } while (elapsed < 0.5);
+
+    // Each byte is counted once on write and once on read
+    return moved / 2.0 / elapsed / 1e6;
+}
+
+// Boot-to-prompt: cold boot the given system image and run the normal
+// polled loop until a TMP prompt ('>') shows up on any console
+static double bench_boot(const std::string& image) {
+    if (!DiskSystem::instance().mount(0, image)) {
+        std::cerr << "Cannot mount " << image << "\n";
+        return -1.0;
+    }
+
+    Z80Runner z80;
+    auto start = Clock::now();
+    if (!z80.boot_from_disk()) return -1.0;
+
+    bool prompt_seen = false;
+    uint8_t drain[256];
+    while (!prompt_seen && seconds_since(start) < 60.0) {
+        if (!z80.run_polled()) break;
+        for (int c = 0; c < MAX_CONSOLES && !prompt_seen; c++) {
+            Console* con = ConsoleManager::instance().get(c);
+            if (!con) continue;
+            size_t n = con->output_queue().read_some(drain, sizeof(drain));
+            for (size_t i = 0; i < n; i++) {
+                if (drain[i] == '>') {
+                    prompt_seen = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    double ms = seconds_since(start) * 1e3;
+    z80.request_stop();
+    DiskSystem::instance().unmount(0);
+    return prompt_seen ? ms : -1.0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string boot_image;
+    int opt;
+    while ((opt = getopt(argc, argv, "d:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                boot_image = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-d system.img]\n";
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    ConsoleManager::instance().init();
+
+    double mips = 0.0, cpi = 0.0;
+    std::cerr << "interpreter...\n";
+    bench_interpreter(mips, cpi);
+    std::cerr << "disk...\n";
+    double iops = bench_disk_iops();
+    std::cerr << "bridge round trip...\n";
+    double rtt = bench_bridge_rtt();
+    std::cerr << "bridge streaming...\n";
+    double stream = bench_bridge_stream();
+    std::cerr << "console...\n";
+    double console_mbps = bench_console();
+
+    double boot_ms = -1.0;
+    if (!boot_image.empty()) {
+        std::cerr << "boot...\n";
+        boot_ms = bench_boot(boot_image);
+    }
+
+    printf("{\n");
+    printf("  \"interp_mips\": %.2f,\n", mips);
+    printf("  \"cycles_per_instr\": %.2f,\n", cpi);
+    printf("  \"disk_iops\": %.0f,\n", iops);
+    printf("  \"bridge_rtt_us\": %.3f,\n", rtt);
+    printf("  \"bridge_stream_mbps\": %.1f,\n", stream);
+    printf("  \"console_mbps\": %.1f,\n", console_mbps);
+    if (boot_ms >= 0.0) {
+        printf("  \"boot_to_prompt_ms\": %.0f\n", boot_ms);
+    } else {
+        printf("  \"boot_to_prompt_ms\": null\n");
+    }
+    printf("}\n");
+
+    return 0;
+}
@@ -358,6 +358,9 @@ class SystemGenerator:
         # System data (256 bytes)
         self.system_data = bytearray(256)
 
+        # Memory regions for the symbol map (name, start, size)
+        self.layout: List[Tuple[str, int, int]] = []
+
         # Cross-reference data captured during loading
         self.resbdos009 = bytearray(3)  # XDOS entry
         self.resbdos012 = bytearray(6)  # XIOS common base
@@ -481,6 +484,7 @@ class SystemGenerator:
 
         # Reserve system data page
         print(f"\n  SYSTEM  DAT  {self.cur_base:02X}00H  0100H")
+        self.layout.append(('SYSTEM_DAT', self.cur_base * 256, 0x100))
 
         # TMPD.DAT region (if consoles > 0)
         if cfg.num_consoles > 0:
@@ -490,6 +494,7 @@ class SystemGenerator:
             self.tmpd_base = self.cur_base
             size = (cfg.num_consoles + 3) // 4
             print(f"  TMPD    DAT  {self.cur_base:02X}00H  {size:02X}00H")
+            self.layout.append(('TMPD_DAT', self.cur_base * 256, size * 256))
 
         # User system call stacks
         usersys_stk_base = 0
@@ -500,11 +505,13 @@ class SystemGenerator:
             size = (cfg.num_mem_segments + 3) // 4
             usersys_stk_base = self.cur_base
             print(f"  USERSYS STK  {self.cur_base:02X}00H  {size:02X}00H")
+            self.layout.append(('USERSYS_STK', self.cur_base * 256, size * 256))
 
         # XIOS jump table
         self.cur_base -= 1
         self.xios_jmp_tbl_base = self.cur_base
         print(f"  XIOSJMP TBL  {self.cur_base:02X}00H  0100H")
+        self.layout.append(('XIOSJMP_TBL', self.cur_base * 256, 0x100))
 
         # Update system data
         self.system_data[7] = self.xios_jmp_tbl_base
@@ -534,6 +541,12 @@ class SystemGenerator:
 
         print(f"  {name:12s}  {base_page:02X}00H  {pages_needed:02X}00H")
 
+        # Record for the symbol map ("RESBDOS SPR" -> RESBDOS,
+        # "SFTP    RSP" -> SFTP_RSP)
+        parts = name.split()
+        map_name = parts[0] if parts[-1] == 'SPR' else '_'.join(parts)
+        self.layout.append((map_name, base_page * 256, pages_needed * 256))
+
         return base_page, pages_needed
 
     def write_module(self, module: SPRModule) -> int:
@@ -851,6 +864,17 @@ class SystemGenerator:
         path.write_bytes(self.system_data)
         print(f"Wrote {len(self.system_data)} bytes to {path}")
 
+    def write_map(self, path: Path) -> None:
+        """Write the memory map for the emulator's sampling profiler.
+
+        One region per line: NAME START END (hex, end inclusive).
+        Loaded by mpm2_emu --profile-map.
+        """
+        lines = [f"{name} {start:04X} {start + size - 1:04X}"
+                 for name, start, size in sorted(self.layout, key=lambda e: e[1])]
+        path.write_text('\n'.join(lines) + '\n')
+        print(f"Wrote {len(self.layout)} regions to {path}")
+
 
 def create_default_config(path: Path) -> None:
     """Create a default configuration file."""
@@ -897,6 +921,8 @@ def main():
         sysdat_path = Path(config.spr_dir) / config.system_dat
         generator.write_system_dat(sysdat_path)
 
+        generator.write_map(output_path.with_suffix('.map'))
+
         return 0
 
     except Exception as e:
@@ -0,0 +1,181 @@
+// mksparse.cpp - Convert disk images to/from the sparse container format
+// Part of MP/M II Emulator
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// The sparse container stores only clusters that hold data; clusters of
+// pure 0xE5 filler (CP/M "empty") are dropped and read back as filler.
+// The emulator auto-detects the format in Disk::open() by magic, so
+// packed images mount like raw ones.
+//
+// Layout (matches Disk::sp_open in src/disk.cpp):
+//   24-byte header: magic "MPM2SPRS", u32 version, u32 cluster size,
+//   u64 virtual (raw) image size
+//   cluster table: u32 per virtual cluster (0 = unallocated)
+//   data region: allocated clusters back to back, cluster-aligned
+//
+// Usage: mksparse pack RAW.IMG SPARSE.IMG
+//        mksparse unpack SPARSE.IMG RAW.IMG
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+static const char SP_MAGIC[8] = {'M', 'P', 'M', '2', 'S', 'P', 'R', 'S'};
+static constexpr uint32_t SP_VERSION = 1;
+static constexpr size_t SP_HEADER_SIZE = 24;
+static constexpr uint32_t CLUSTER_SIZE = 4096;
+
+void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " pack RAW.IMG SPARSE.IMG\n"
+              << "       " << prog << " unpack SPARSE.IMG RAW.IMG\n"
+              << "\n"
+              << "pack drops clusters of pure 0xE5 filler; unpack restores\n"
+              << "a raw image byte-identical to the original.\n";
+}
+
+static bool is_filler(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] != 0xE5) return false;
+    }
+    return true;
+}
+
+static int do_pack(const std::string& raw_path, const std::string& out_path) {
+    std::ifstream in(raw_path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: Cannot open " << raw_path << "\n";
+        return 1;
+    }
+    in.seekg(0, std::ios::end);
+    uint64_t raw_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+    if (raw_size == 0) {
+        std::cerr << "Error: Empty input image\n";
+        return 1;
+    }
+
+    size_t clusters = (raw_size + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    std::vector<uint32_t> table(clusters, 0);
+    size_t data_start = (SP_HEADER_SIZE + clusters * 4 + CLUSTER_SIZE - 1)
+                        & ~static_cast<size_t>(CLUSTER_SIZE - 1);
+
+    std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Cannot create " << out_path << "\n";
+        return 1;
+    }
+
+    // Data pass first; header and table are rewritten at the end
+    out.seekp(data_start, std::ios::beg);
+    std::vector<uint8_t> buf(CLUSTER_SIZE);
+    uint32_t allocated = 0;
+    for (size_t c = 0; c < clusters; c++) {
+        std::memset(buf.data(), 0xE5, CLUSTER_SIZE);
+        size_t want = static_cast<size_t>(
+            std::min<uint64_t>(CLUSTER_SIZE, raw_size - c * (uint64_t)CLUSTER_SIZE));
+        in.read(reinterpret_cast<char*>(buf.data()), want);
+        if (!is_filler(buf.data(), CLUSTER_SIZE)) {
+            table[c] = ++allocated;
+            out.write(reinterpret_cast<const char*>(buf.data()), CLUSTER_SIZE);
+        }
+    }
+
+    out.seekp(0, std::ios::beg);
+    out.write(SP_MAGIC, sizeof(SP_MAGIC));
+    uint32_t version = SP_VERSION;
+    uint32_t cluster_size = CLUSTER_SIZE;
+    out.write(reinterpret_cast<const char*>(&version), 4);
+    out.write(reinterpret_cast<const char*>(&cluster_size), 4);
+    out.write(reinterpret_cast<const char*>(&raw_size), 8);
+    out.write(reinterpret_cast<const char*>(table.data()), clusters * 4);
+    if (!out.good()) {
+        std::cerr << "Error: Write failed on " << out_path << "\n";
+        return 1;
+    }
+
+    uint64_t packed = data_start + static_cast<uint64_t>(allocated) * CLUSTER_SIZE;
+    std::cout << "Packed " << raw_path << " (" << raw_size << " bytes) -> "
+              << out_path << " (" << packed << " bytes, "
+              << allocated << "/" << clusters << " clusters)\n";
+    return 0;
+}
+
+static int do_unpack(const std::string& in_path, const std::string& out_path) {
+    std::ifstream in(in_path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: Cannot open " << in_path << "\n";
+        return 1;
+    }
+
+    uint8_t header[SP_HEADER_SIZE];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    uint32_t version, cluster_size;
+    uint64_t raw_size;
+    std::memcpy(&version, header + 8, 4);
+    std::memcpy(&cluster_size, header + 12, 4);
+    std::memcpy(&raw_size, header + 16, 8);
+    if (!in.good() || std::memcmp(header, SP_MAGIC, sizeof(SP_MAGIC)) != 0 ||
+        version != SP_VERSION || cluster_size == 0) {
+        std::cerr << "Error: Not a sparse image: " << in_path << "\n";
+        return 1;
+    }
+
+    size_t clusters = (raw_size + cluster_size - 1) / cluster_size;
+    std::vector<uint32_t> table(clusters);
+    in.read(reinterpret_cast<char*>(table.data()), clusters * 4);
+    size_t data_start = (SP_HEADER_SIZE + clusters * 4 + cluster_size - 1)
+                        & ~static_cast<size_t>(cluster_size - 1);
+
+    std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Cannot create " << out_path << "\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> buf(cluster_size);
+    for (size_t c = 0; c < clusters; c++) {
+        if (table[c] == 0) {
+            std::memset(buf.data(), 0xE5, cluster_size);
+        } else {
+            in.seekg(data_start + static_cast<uint64_t>(table[c] - 1) * cluster_size,
+                     std::ios::beg);
+            in.read(reinterpret_cast<char*>(buf.data()), cluster_size);
+            if (!in.good()) {
+                std::cerr << "Error: Truncated sparse image\n";
+                return 1;
+            }
+        }
+        size_t want = static_cast<size_t>(
+            std::min<uint64_t>(cluster_size, raw_size - c * (uint64_t)cluster_size));
+        out.write(reinterpret_cast<const char*>(buf.data()), want);
+    }
+    if (!out.good()) {
+        std::cerr << "Error: Write failed on " << out_path << "\n";
+        return 1;
+    }
+
+    std::cout << "Unpacked " << in_path << " -> " << out_path
+              << " (" << raw_size << " bytes)\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string mode = argv[1];
+    if (mode == "pack") {
+        return do_pack(argv[2], argv[3]);
+    }
+    if (mode == "unpack") {
+        return do_unpack(argv[2], argv[3]);
+    }
+
+    print_usage(argv[0]);
+    return 1;
+}